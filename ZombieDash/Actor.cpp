@@ -3,7 +3,7 @@
 #include "GameConstants.h"
 
 // Actor Class Implementations
-Actor::Actor(int imageID, int startX, int startY, Direction startDirection, int depth, StudentWorld* stWorld) : GraphObject(imageID, startX, startY, startDirection, depth), m_alive(true), m_world(stWorld) {}
+Actor::Actor(int imageID, int startX, int startY, Direction startDirection, int depth, StudentWorld* stWorld) : GraphObject(imageID, startX, startY, startDirection, depth, 1.0, &stWorld->renderList()), m_alive(true), m_properties(0), m_world(stWorld) {}
 bool Actor::alive() const {return m_alive;}
 bool Actor::flammable() const {return true;}
 bool Actor::infectable() const {return false;}
@@ -11,24 +11,49 @@ bool Actor::blocksMovement() const {return false;}
 bool Actor::blocksFlames() const {return false;}
 bool Actor::blocksVomit() const {return blocksFlames();}
 bool Actor::pitDestructible() const {return false;}
+bool Actor::fixed() const {return false;}
+bool Actor::inert() const {return false;}
+bool Actor::trigger() const {return false;}
+bool Actor::smart() const {return false;}
 StudentWorld* Actor::world() const {return m_world;}
-void Actor::setDead() {m_alive = false;}
-void Actor::destroy() {m_alive = false;}
+void Actor::setDead() {
+    if (!m_alive) return;
+    m_alive = false;
+    m_world->actorDied(this);
+}
+void Actor::destroy() {setDead();}
 void Actor::infect() {return;}
+void Actor::prepare(std::uint64_t /* seed */, std::uint64_t /* stream */) {return;}
+void Actor::dispose() {world()->releaseActor(this);}
+void Actor::timerExpired() {return;}
+void Actor::moveTo(double x, double y) {
+    double oldX = getX();
+    double oldY = getY();
+    GraphObject::moveTo(x, y);
+    m_world->actorMoved(this, oldX, oldY);
+}
+void Actor::cacheProperties() {
+    m_properties = (flammable() ? FLAMMABLE : 0) | (infectable() ? INFECTABLE : 0) | (blocksMovement() ? BLOCKS_MOVEMENT : 0)
+                 | (blocksFlames() ? BLOCKS_FLAMES : 0) | (blocksVomit() ? BLOCKS_VOMIT : 0) | (pitDestructible() ? PIT_DESTRUCTIBLE : 0)
+                 | (fixed() ? FIXED : 0) | (inert() ? INERT : 0) | (trigger() ? TRIGGER : 0) | (smart() ? SMART : 0);
+}
 
 // Terrain Class Implementations
 Terrain::Terrain(int imageID, int startX, int startY, int depth, StudentWorld* stWorld) : Actor(imageID, startX, startY, GraphObject::right, depth, stWorld) {}
 bool Terrain::flammable() const {return false;}
+bool Terrain::fixed() const {return true;}
 
 // Wall Class Implementations
 Wall::Wall(int startX, int startY, StudentWorld* stWorld) : Terrain(IID_WALL, startX, startY, 0, stWorld) {}
 bool Wall::blocksMovement() const {return true;}
 bool Wall::blocksFlames() const {return true;}
+bool Wall::inert() const {return true;}
 void Wall::doSomething() {return;}
 
 Exit::Exit(int startX, int startY, StudentWorld* stWorld) : Terrain(IID_EXIT, startX, startY, 1, stWorld) {}
 bool Exit::blocksFlames() const {return true;}
 bool Exit::blocksVomit() const {return false;}
+bool Exit::trigger() const {return true;}
 void Exit::doSomething() {
     // Make any overlapping citizens exit
     world()->exitCitizens(getX(), getY());
@@ -38,33 +63,36 @@ void Exit::doSomething() {
 
 // Pit Class Implementations
 Pit::Pit(int startX, int startY, StudentWorld* stWorld) : Terrain(IID_PIT, startX, startY, 0, stWorld) {}
-void Pit::doSomething() {world()->destroyOfType(getX(), getY(), &Actor::pitDestructible);}
+bool Pit::trigger() const {return true;}
+void Pit::doSomething() {world()->destroyOfType(getX(), getY(), Actor::PIT_DESTRUCTIBLE);}
 
 // Projectile Class Implementations
-Projectile::Projectile(int imageID, int startX, int startY, Direction startDirection, StudentWorld* stWorld) : Actor(imageID, startX, startY, startDirection, 0, stWorld), m_ticksLeft(2) {}
+Projectile::Projectile(int imageID, int startX, int startY, Direction startDirection, StudentWorld* stWorld) : Actor(imageID, startX, startY, startDirection, 0, stWorld) {
+    // Nothing looks for projectiles, so it makes no difference that it dies before, rather than on, its second turn
+    stWorld->schedule(m_expiry, this, 2);
+}
 bool Projectile::flammable() const {return false;}
 void Projectile::doSomething() {
     // If the projectile is not alive, do nothing
     if (!alive()) return;
-    // If the projectile was created two ticks ago, destroy it and do nothing else
-    if (--m_ticksLeft <= 0) {
-        setDead();
-        return;
-    }
     // Otherwise, infect or destroy as appropriate
     affect();
 }
+void Projectile::timerExpired() {setDead();}
 
 // Flame Class Implementations
 Flame::Flame(int startX, int startY, Direction startDirection, StudentWorld* stWorld) : Projectile(IID_FLAME, startX, startY, startDirection, stWorld) {}
-void Flame::affect() {world()->destroyOfType(getX(), getY(), &Actor::flammable);}
+void Flame::affect() {world()->destroyOfType(getX(), getY(), Actor::FLAMMABLE);}
+void Flame::dispose() {world()->releaseFlame(this);}
 
 // Vomit Class Implementations
 Vomit::Vomit(int startX, int startY, Direction startDirection, StudentWorld* stWorld) : Projectile(IID_VOMIT, startX, startY, startDirection, stWorld) {}
 void Vomit::affect() {world()->infectInfectables(getX(), getY());}
+void Vomit::dispose() {world()->releaseVomit(this);}
 
 // Goodie Class Implementations
 Goodie::Goodie(int imageID, int startX, int startY, StudentWorld* stWorld) : Actor(imageID, startX, startY, GraphObject::right, 1, stWorld) {}
+bool Goodie::trigger() const {return true;}
 void Goodie::doSomething() {
     // If the goodie has been destroyed, do nothing
     if (!alive()) return;
@@ -90,16 +118,17 @@ LandmineGoodie::LandmineGoodie(int startX, int startY, StudentWorld* stWorld) :
 void LandmineGoodie::receiveGoodies() {world()->adjustLandmines(2);}
 
 // Landmine Class Implementations
-Landmine::Landmine(int startX, int startY, StudentWorld* stWorld) : Actor(IID_LANDMINE, startX, startY, GraphObject::right, 1, stWorld), m_safetyTicks(30), m_active(false) {}
+Landmine::Landmine(int startX, int startY, StudentWorld* stWorld) : Actor(IID_LANDMINE, startX, startY, GraphObject::right, 1, stWorld), m_active(false) {
+    // The landmine spends its first 30 turns becoming active, and so first looks for people on its 31st
+    stWorld->schedule(m_safety, this, 31);
+}
+bool Landmine::trigger() const {return true;}
 void Landmine::doSomething() {
-    if (!alive()) return;
-    if (!m_active) {
-        if (--m_safetyTicks == 0) m_active = true;
-        return;
-    }
-    if (world()->overlapOfType(getX(), getY(), &Actor::pitDestructible))
+    if (!alive() || !m_active) return;
+    if (world()->overlapOfType(getX(), getY(), Actor::PIT_DESTRUCTIBLE))
         destroy();
 }
+void Landmine::timerExpired() {m_active = true;}
 void Landmine::destroy() {
     // Set state of landmine to dead
     setDead();
@@ -108,58 +137,88 @@ void Landmine::destroy() {
     // Create flames at and around the landmine
     int x = getX();
     int y = getY();
-    world()->addActor(new Flame(x, y, GraphObject::up, world()));
-    if (!world()->overlapOfType(x+SPRITE_WIDTH, y, &Actor::blocksFlames))
-        world()->addActor(new Flame(x+SPRITE_WIDTH, y, GraphObject::up, world()));
-    if (!world()->overlapOfType(x+SPRITE_WIDTH, y+SPRITE_HEIGHT, &Actor::blocksFlames))
-        world()->addActor(new Flame(x+SPRITE_WIDTH, y+SPRITE_HEIGHT, GraphObject::up, world()));
-    if (!world()->overlapOfType(x, y+SPRITE_HEIGHT, &Actor::blocksFlames))
-        world()->addActor(new Flame(x, y+SPRITE_HEIGHT, GraphObject::up, world()));
-    if (!world()->overlapOfType(x-SPRITE_WIDTH, y+SPRITE_HEIGHT, &Actor::blocksFlames))
-        world()->addActor(new Flame(x-SPRITE_WIDTH, y+SPRITE_HEIGHT, GraphObject::up, world()));
-    if (!world()->overlapOfType(x-SPRITE_WIDTH, y, &Actor::blocksFlames))
-        world()->addActor(new Flame(x-SPRITE_WIDTH, y, GraphObject::up, world()));
-    if (!world()->overlapOfType(x-SPRITE_WIDTH, y-SPRITE_HEIGHT, &Actor::blocksFlames))
-        world()->addActor(new Flame(x-SPRITE_WIDTH, y-SPRITE_HEIGHT, GraphObject::up, world()));
-    if (!world()->overlapOfType(x, y-SPRITE_HEIGHT, &Actor::blocksFlames))
-        world()->addActor(new Flame(x, y-SPRITE_HEIGHT, GraphObject::up, world()));
-    if (!world()->overlapOfType(x+SPRITE_WIDTH, y-SPRITE_HEIGHT, &Actor::blocksFlames))
-        world()->addActor(new Flame(x+SPRITE_WIDTH, y-SPRITE_HEIGHT, GraphObject::up, world()));
+    world()->addFlame(x, y, GraphObject::up);
+    if (!world()->overlapOfType(x+SPRITE_WIDTH, y, Actor::BLOCKS_FLAMES))
+        world()->addFlame(x+SPRITE_WIDTH, y, GraphObject::up);
+    if (!world()->overlapOfType(x+SPRITE_WIDTH, y+SPRITE_HEIGHT, Actor::BLOCKS_FLAMES))
+        world()->addFlame(x+SPRITE_WIDTH, y+SPRITE_HEIGHT, GraphObject::up);
+    if (!world()->overlapOfType(x, y+SPRITE_HEIGHT, Actor::BLOCKS_FLAMES))
+        world()->addFlame(x, y+SPRITE_HEIGHT, GraphObject::up);
+    if (!world()->overlapOfType(x-SPRITE_WIDTH, y+SPRITE_HEIGHT, Actor::BLOCKS_FLAMES))
+        world()->addFlame(x-SPRITE_WIDTH, y+SPRITE_HEIGHT, GraphObject::up);
+    if (!world()->overlapOfType(x-SPRITE_WIDTH, y, Actor::BLOCKS_FLAMES))
+        world()->addFlame(x-SPRITE_WIDTH, y, GraphObject::up);
+    if (!world()->overlapOfType(x-SPRITE_WIDTH, y-SPRITE_HEIGHT, Actor::BLOCKS_FLAMES))
+        world()->addFlame(x-SPRITE_WIDTH, y-SPRITE_HEIGHT, GraphObject::up);
+    if (!world()->overlapOfType(x, y-SPRITE_HEIGHT, Actor::BLOCKS_FLAMES))
+        world()->addFlame(x, y-SPRITE_HEIGHT, GraphObject::up);
+    if (!world()->overlapOfType(x+SPRITE_WIDTH, y-SPRITE_HEIGHT, Actor::BLOCKS_FLAMES))
+        world()->addFlame(x+SPRITE_WIDTH, y-SPRITE_HEIGHT, GraphObject::up);
     // Create pit object at landmine
-    world()->addActor(new Pit(x, y, world()));
+    world()->spawn<Pit>(x, y);
 }
 
-Person::Person(int imageID, int startX, int startY, StudentWorld* stWorld, int sound_infect, int sound_flame, int score_value, int step_distance) : Actor(imageID, startX, startY, GraphObject::right, 0, stWorld), m_infected(false), m_paralyzed(false), m_infection(0), m_score_value(score_value), m_sound_infect(sound_infect), m_sound_flame(sound_flame), m_step_distance(step_distance) {}
+Person::Person(int imageID, int startX, int startY, StudentWorld* stWorld, int sound_infect, int sound_flame, int score_value, int step_distance) : Actor(imageID, startX, startY, GraphObject::right, 0, stWorld), m_infected(false), m_infectionDue(false), m_prepared(false), m_born(stWorld->ticks()), m_lastTurn(stWorld->ticks()), m_infectionStart(0), m_score_value(score_value), m_sound_infect(sound_infect), m_sound_flame(sound_flame), m_step_distance(step_distance) {}
 bool Person::blocksMovement() const {return true;}
 bool Person::pitDestructible() const {return true;}
-int Person::infection() const {return m_infection;}
-bool Person::paralyzed() {return !(m_paralyzed = !m_paralyzed);}
+int Person::infection() const {
+    if (!m_infected) return 0;
+    long now = world()->ticks();
+    return now - m_infectionStart + (m_lastTurn == now ? 1 : 0);
+}
+bool Person::paralyzed() const {return (world()->ticks() - m_born) % 2 == 0;} // Not on the first turn, the tick after being created
 bool Person::infected() const {return m_infected;}
-void Person::infect() {m_infected = true;}
+void Person::infect() {
+    if (m_infected) return;
+    m_infected = true;
+    // The infection counts this person's turns, starting with this tick's if it has not had it yet, and runs its course on the 500th
+    long now = world()->ticks();
+    m_infectionStart = m_lastTurn == now ? now + 1 : now;
+    world()->schedule(m_infectionTimer, this, m_infectionStart + 499 - now);
+}
+void Person::timerExpired() {m_infectionDue = true;}
 void Person::doSomething() {
+    bool prepared = m_prepared;
+    m_prepared = false;
     if (!alive()) return;
-    if (m_infected && ++m_infection >= 500) {
+    m_lastTurn = world()->ticks();
+    if (m_infectionDue) {
         destroy();
         return;
     }
     if (paralyzed()) return;
-    doAction();
+    if (prepared) act();
+    else doAction();
 }
+void Person::prepare(std::uint64_t seed, std::uint64_t stream) {
+    // Only decide for people who will get to act: not dead, about to die of infection, or paralyzed this tick
+    m_prepared = false;
+    if (!alive() || m_infectionDue || paralyzed()) return;
+    RandomGenerator rng(seed, stream);
+    decide(rng);
+    m_prepared = true;
+}
+void Person::doAction() {
+    decide(world()->aiRandom());
+    act();
+}
+void Person::decide(RandomGenerator& /* rng */) {return;}
+void Person::act() {return;}
 void Person::destroy() {
     setDead();
-    if (m_infection >= 500 && m_sound_infect != SOUND_NONE)
+    if (infection() >= 500 && m_sound_infect != SOUND_NONE)
         world()->playSound(m_sound_infect);
     else if (m_sound_flame != SOUND_NONE)
         world()->playSound(m_sound_flame);
     world()->increaseScore(m_score_value);
-    if (m_infection >= 500 && world()->distPenelope(getX(), getY()) != 0) {
-        if (randInt(1, 10) <= 7)
-            world()->addActor(new Zombie(getX(), getY(), world()));
+    if (infection() >= 500 && !world()->withinDistPenelope(getX(), getY(), 0)) {
+        if (world()->spawnRandom().randInt(1, 10) <= 7)
+            world()->spawn<Zombie>(getX(), getY());
         else
-            world()->addActor(new SmartZombie(getX(), getY(), world()));
+            world()->spawn<SmartZombie>(getX(), getY());
     }
-    if (!infectable() && m_score_value == 1000 && randInt(1, 10) == 1) {
-        Direction d = world()->randDirection();
+    if (!infectable() && m_score_value == 1000 && world()->spawnRandom().randInt(1, 10) == 1) {
+        Direction d = world()->randDirection(world()->spawnRandom());
         int x = getX();
         int y = getY();
         switch(d) {
@@ -176,13 +235,13 @@ void Person::destroy() {
                 y += SPRITE_HEIGHT;
         }
         if (world()->isValidDestination(x, y, NULL))
-            world()->addActor(new VaccineGoodie(x, y, world()));
+            world()->spawn<VaccineGoodie>(x, y);
     }
 }
     
-bool Person::moveDirection(Direction dir) {
-    int x = getX();
-    int y = getY();
+void Person::destination(Direction dir, int& x, int& y) const {
+    x = getX();
+    y = getY();
     switch (dir) {
         case GraphObject::up:
             y += m_step_distance;
@@ -196,6 +255,15 @@ bool Person::moveDirection(Direction dir) {
         case GraphObject::right:
             x += m_step_distance;
     }
+}
+bool Person::canMove(Direction dir) const {
+    int x, y;
+    destination(dir, x, y);
+    return world()->isValidDestination(x, y, this);
+}
+bool Person::moveDirection(Direction dir) {
+    int x, y;
+    destination(dir, x, y);
     if (world()->isValidDestination(x, y, this)) {
         setDirection(dir);
         moveTo(x, y);
@@ -206,7 +274,7 @@ bool Person::moveDirection(Direction dir) {
 
 Penelope::Penelope(int startX, int startY, StudentWorld* stWorld) : Person(IID_PLAYER, startX, startY, stWorld, SOUND_PLAYER_DIE, SOUND_PLAYER_DIE, 0, 4), m_landmines(0), m_flameCharges(0), m_vaccines(0) {}
 bool Penelope::infectable() const {return true;}
-bool Penelope::paralyzed() {return false;}
+bool Penelope::paralyzed() const {return false;}
 int Penelope::landmines() const {return m_landmines;}
 int Penelope::flameCharges() const {return m_flameCharges;}
 int Penelope::vaccines() const {return m_vaccines;}
@@ -215,7 +283,8 @@ void Penelope::adjustFlameCharges(int num) {m_flameCharges += num;}
 void Penelope::adjustVaccines(int num) {m_vaccines += num;}
 void Person::resetInfection() {
     m_infected = false;
-    m_infection = 0;
+    m_infectionDue = false;
+    m_infectionTimer.cancel();
 }
 void Penelope::doAction() {
     int key;
@@ -244,26 +313,26 @@ void Penelope::doAction() {
                     switch (getDirection()) {
                         case GraphObject::right:
                             for (int i = 1; i <= 3; i++) {
-                                if (world()->overlapOfType(getX() + SPRITE_WIDTH*i, getY(), &Actor::blocksFlames)) return;
-                                world()->addActor(new Flame(getX()+SPRITE_WIDTH*i, getY(), GraphObject::right, world()));
+                                if (world()->overlapOfType(getX() + SPRITE_WIDTH*i, getY(), Actor::BLOCKS_FLAMES)) return;
+                                world()->addFlame(getX()+SPRITE_WIDTH*i, getY(), GraphObject::right);
                             }
                             break;
                         case GraphObject::left:
                             for (int i = 1; i <= 3; i++) {
-                                if (world()->overlapOfType(getX() - SPRITE_WIDTH*i, getY(), &Actor::blocksFlames)) return;
-                                world()->addActor(new Flame(getX()-SPRITE_WIDTH*i, getY(), GraphObject::right, world()));
+                                if (world()->overlapOfType(getX() - SPRITE_WIDTH*i, getY(), Actor::BLOCKS_FLAMES)) return;
+                                world()->addFlame(getX()-SPRITE_WIDTH*i, getY(), GraphObject::right);
                             }
                             break;
                         case GraphObject::up:
                             for (int i = 1; i <= 3; i++) {
-                                if (world()->overlapOfType(getX(), getY() + SPRITE_HEIGHT*i, &Actor::blocksFlames)) return;
-                                world()->addActor(new Flame(getX(), getY()+SPRITE_HEIGHT*i, GraphObject::up, world()));
+                                if (world()->overlapOfType(getX(), getY() + SPRITE_HEIGHT*i, Actor::BLOCKS_FLAMES)) return;
+                                world()->addFlame(getX(), getY()+SPRITE_HEIGHT*i, GraphObject::up);
                             }
                             break;
                         case GraphObject::down:
                             for (int i = 1; i <= 3; i++) {
-                                if (world()->overlapOfType(getX(), getY() - SPRITE_HEIGHT*i, &Actor::blocksFlames)) return;
-                                world()->addActor(new Flame(getX(), getY()-SPRITE_HEIGHT*i, GraphObject::down, world()));
+                                if (world()->overlapOfType(getX(), getY() - SPRITE_HEIGHT*i, Actor::BLOCKS_FLAMES)) return;
+                                world()->addFlame(getX(), getY()-SPRITE_HEIGHT*i, GraphObject::down);
                             }
                     }
                 }
@@ -271,7 +340,7 @@ void Penelope::doAction() {
             case KEY_PRESS_TAB:
                 if (m_landmines > 0) {
                     m_landmines--;
-                    world()->addActor(new Landmine(getX(), getY(), world()));
+                    world()->spawn<Landmine>(getX(), getY());
                 }
                 break;
             case KEY_PRESS_ENTER:
@@ -289,47 +358,48 @@ void Citizen::infect() {
     if (!infected()) world()->playSound(SOUND_CITIZEN_INFECTED);
     Person::infect();
 }
-void Citizen::doAction() {
+void Citizen::decide(RandomGenerator& rng) {
+    m_moving = false;
     double dist_p = world()->distPenelope(getX(), getY()); // Distance to Penelope
     double dist_z = world()->distZombie(getX(), getY()); // Distance to the nearest zombie
-    if (dist_p < dist_z && dist_p <= 80) {
+    if (dist_p < dist_z && world()->withinDistPenelope(getX(), getY(), 80)) {
         // If Penelope is closer than the nearest zombie and is closer than 80 pixels away
         int penelopeX = world()->penelopeX(); // Penelope's x-coordinate
         int penelopeY = world()->penelopeY(); // Penelope's y-coordinate
         // If zombie is on the same row or column as Penelope, try moving towards Penelope
         if (getX() == penelopeX) {
             if (getY() > penelopeY) {
-                if (moveDirection(GraphObject::down)) return;
+                if (intendMove(GraphObject::down)) return;
             }
-            else if (moveDirection(GraphObject::up)) return;
+            else if (intendMove(GraphObject::up)) return;
         }
         else if (getY() == penelopeY) {
             if (getX() > penelopeX) {
-                if (moveDirection(GraphObject::left)) return;
+                if (intendMove(GraphObject::left)) return;
             }
-            else if (moveDirection(GraphObject::right)) return;
+            else if (intendMove(GraphObject::right)) return;
         }
         else {
             // Otherwise, randomly try one of the two directions to move closer to Penelope, then try the other
-            if (randInt(0, 1) == 0) {
+            if (rng.randInt(0, 1) == 0) {
                 if (getX() > penelopeX) {
-                    if (moveDirection(GraphObject::left)) return;
+                    if (intendMove(GraphObject::left)) return;
                 }
-                else if (moveDirection(GraphObject::right)) return;
+                else if (intendMove(GraphObject::right)) return;
                 if (getY() > penelopeY) {
-                    if (moveDirection(GraphObject::down)) return;
+                    if (intendMove(GraphObject::down)) return;
                 }
-                else if (moveDirection(GraphObject::up)) return;
+                else if (intendMove(GraphObject::up)) return;
             }
             else {
                 if (getY() > penelopeY) {
-                    if (moveDirection(GraphObject::down)) return;
+                    if (intendMove(GraphObject::down)) return;
                 }
-                else if (moveDirection(GraphObject::up)) return;
+                else if (intendMove(GraphObject::up)) return;
                 if (getX() > penelopeX) {
-                    if (moveDirection(GraphObject::left)) return;
+                    if (intendMove(GraphObject::left)) return;
                 }
-                else if (moveDirection(GraphObject::right)) return;
+                else if (intendMove(GraphObject::right)) return;
             }
         }
     }
@@ -342,41 +412,54 @@ void Citizen::doAction() {
         double dist_right = world()->isValidDestination(getX()+2, getY(), this) ? world()->distZombie(getX()+2, getY()) : -1;
         // Move (or stay still) to maximize the distance to the nearest zombie
         if (dist_up != -1 && dist_up > dist_down && dist_up > dist_left && dist_up > dist_right && dist_up > dist_z) {
-            setDirection(GraphObject::up);
-            moveTo(getX(), getY() + 2);
+            intendMove(GraphObject::up);
             return;
         }
         if (dist_down != -1 && dist_down > dist_left && dist_down > dist_right && dist_down > dist_z) {
-            setDirection(GraphObject::down);
-            moveTo(getX(), getY() - 2);
+            intendMove(GraphObject::down);
             return;
         }
         if (dist_left != -1 && dist_left > dist_right && dist_left > dist_z) {
-            setDirection(GraphObject::left);
-            moveTo(getX() - 2, getY());
+            intendMove(GraphObject::left);
             return;
         }
         if (dist_right != -1 && dist_right > dist_z) {
-            setDirection(GraphObject::right);
-            moveTo(getX() + 2, getY());
+            intendMove(GraphObject::right);
             return;
         }
     }
     // If all else fails, do nothing
 }
+void Citizen::act() {
+    if (m_moving) moveDirection(m_step);
+}
+bool Citizen::intendMove(Direction dir) {
+    if (!canMove(dir)) return false;
+    m_moving = true;
+    m_step = dir;
+    return true;
+}
 
-Zombie::Zombie(int startX, int startY, StudentWorld* stWorld, int score_value) : Person(IID_ZOMBIE, startX, startY, stWorld, SOUND_NONE, SOUND_ZOMBIE_DIE, score_value, 1), m_movementPlan(0) {}
-void Zombie::doAction() {
+Zombie::Zombie(int startX, int startY, StudentWorld* stWorld, int score_value) : Person(IID_ZOMBIE, startX, startY, stWorld, SOUND_NONE, SOUND_ZOMBIE_DIE, score_value, 1), m_movementPlan(0), m_vomiting(false), m_vomitX(0), m_vomitY(0) {}
+void Zombie::decide(RandomGenerator& rng) {
     // Vomit on nearby infectables
-    if (vomit()) return;
+    m_vomiting = vomit(rng);
+    if (m_vomiting) return;
     if (m_movementPlan == 0) {
-        m_movementPlan = randInt(3, 10);
-        movementPlan();
+        m_movementPlan = rng.randInt(3, 10);
+        movementPlan(m_movementPlan, rng);
+    }
+}
+void Zombie::act() {
+    if (m_vomiting) {
+        world()->addVomit(m_vomitX, m_vomitY, getDirection());
+        world()->playSound(SOUND_ZOMBIE_VOMIT);
+        return;
     }
     // Move 1 pixel forward, and decrement movement plan distance. If blocked, set movement plan to 0 instead.
     m_movementPlan = moveDirection(getDirection()) ? m_movementPlan - 1 : 0;
 }
-bool Zombie::vomit() {
+bool Zombie::vomit(RandomGenerator& rng) {
     int vomitX = getX();
     int vomitY = getY();
     switch (getDirection()) {
@@ -392,16 +475,17 @@ bool Zombie::vomit() {
         case GraphObject::down:
             vomitY -= SPRITE_HEIGHT;
     }
-    if (world()->overlapOfType(vomitX, vomitY, &Actor::infectable) && randInt(1,3) == 1) {
-        if (!world()->overlapOfType(vomitX, vomitY, &Actor::blocksVomit)) {
-            world()->addActor(new Vomit(vomitX, vomitY, getDirection(), world()));
-            world()->playSound(SOUND_ZOMBIE_VOMIT);
+    if (world()->overlapOfType(vomitX, vomitY, Actor::INFECTABLE) && rng.randInt(1,3) == 1) {
+        if (!world()->overlapOfType(vomitX, vomitY, Actor::BLOCKS_VOMIT)) {
+            m_vomitX = vomitX;
+            m_vomitY = vomitY;
             return true;
         }
     }
     return false;
 }
-void Zombie::movementPlan() {setDirection(world()->randDirection());}
+void Zombie::movementPlan(int& /* distance */, RandomGenerator& rng) {setDirection(world()->randDirection(rng));}
 
 SmartZombie::SmartZombie(int startX, int startY, StudentWorld* stWorld) : Zombie(startX, startY, stWorld, 2000) {}
-void SmartZombie::movementPlan() {setDirection(world()->smartDirection(getX(), getY()));}
+bool SmartZombie::smart() const {return true;}
+void SmartZombie::movementPlan(int& distance, RandomGenerator& rng) {setDirection(world()->smartDirection(getX(), getY(), distance, rng));}
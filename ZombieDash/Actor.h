@@ -2,8 +2,11 @@
 #define ACTOR_H_
 
 #include "GraphObject.h"
+#include "TimerWheel.h"
+#include <cstdint>
 
 class StudentWorld;
+class RandomGenerator;
 
 /* Actor Class Declaration
  * - Base class for all actors in Zombie Dash
@@ -12,6 +15,20 @@ class StudentWorld;
  */
 class Actor : public GraphObject {
 public:
+    // Property flags, one bit for each of the property functions below
+    enum Property {
+        FLAMMABLE        = 1 << 0,
+        INFECTABLE       = 1 << 1,
+        BLOCKS_MOVEMENT  = 1 << 2,
+        BLOCKS_FLAMES    = 1 << 3,
+        BLOCKS_VOMIT     = 1 << 4,
+        PIT_DESTRUCTIBLE = 1 << 5,
+        FIXED            = 1 << 6,
+        INERT            = 1 << 7,
+        TRIGGER          = 1 << 8,
+        SMART            = 1 << 9
+    };
+    
     // Constructor
     Actor(int imageID, int startX, int startY, Direction startDirection, int depth, StudentWorld* stWorld);
     
@@ -22,20 +39,32 @@ public:
     virtual bool blocksFlames() const; // Default of false (does not block flames)
     virtual bool blocksVomit() const; // Default of same thing as blocksFlames()
     virtual bool pitDestructible() const;   // Default of false (cannot be destroyed by a pit)
+    virtual bool fixed() const;             // Default of false (may move or die)
+    virtual bool inert() const;             // Default of false (doSomething() may do something)
+    virtual bool trigger() const;           // Default of false (acts on its own, rather than only on what is on it)
+    virtual bool smart() const;             // Default of false (does not find its way around walls)
     
     // Accessors
     bool alive() const; // Returns whether this actor is alive
+    int properties() const {return m_properties;} // Returns the property flags saved by cacheProperties()
+    bool hasProperties(int mask) const {return (m_properties & mask) == mask;} // Returns whether this actor has every property in mask
     
     // Mutators
-    void setDead();         // Directly sets state of actor to dead
+    void setDead();         // Directly sets state of actor to dead, and tells the StudentWorld
     virtual void destroy(); // Destroys actor as if by destroyed by fire
     virtual void doSomething() = 0;
     virtual void infect();
+    virtual void moveTo(double x, double y); // Moves this actor and tells the StudentWorld so it can keep track of where it is
+    void cacheProperties(); // Saves the property functions as flags; must be called once the actor is fully constructed
+    virtual void prepare(std::uint64_t seed, std::uint64_t stream); // Works out ahead of time what the next doSomething() will do, only reading the rest of the world and drawing random numbers from (seed, stream); default of nothing
+    virtual void dispose(); // Destroys this actor; default of returning its memory to the level's arena, but pooled actors go back to their pool
+    virtual void timerExpired(); // Called at the start of the tick a timer this actor scheduled with the StudentWorld goes off; default of nothing
 protected:
     // Accessors
     StudentWorld* world() const; // Returns a pointer to the Studentworld that "contains" this actor
 private:
     bool m_alive; // Whether this actor is alive
+    int m_properties; // Property flags, so queries over many actors need no virtual calls
     StudentWorld* m_world; // Pointer to Studentworld that "contains" this actor
 };
 
@@ -50,6 +79,7 @@ public:
     
     // Properties
     virtual bool flammable() const; // Terrain objects are not flammable
+    virtual bool fixed() const;     // Terrain objects never move or die
 };
 
 // Wall Class Declaration
@@ -61,6 +91,7 @@ public:
     // Properties
     virtual bool blocksMovement() const;    // Walls do block movement
     virtual bool blocksFlames() const; // Walls do block projectiles
+    virtual bool inert() const;        // Walls never do anything
     
     // Mutators
     virtual void doSomething(); // Do nothing
@@ -75,6 +106,7 @@ public:
     // Properties
     virtual bool blocksFlames() const; // Exits do block projectiles
     virtual bool blocksVomit() const; // Exits do not block vomit
+    virtual bool trigger() const;     // Exits only act on citizens and Penelope on them
     
     // Mutators
     virtual void doSomething(); // Make overlapping citizens and Penelope exit
@@ -86,6 +118,9 @@ public:
     // Constructor
     Pit(int startX, int startY, StudentWorld* stWorld);
     
+    // Properties
+    virtual bool trigger() const; // Pits only act on people in them
+    
     // Mutators
     virtual void doSomething(); // Destroy overlapping pit-destructible actors
 };
@@ -93,6 +128,7 @@ public:
 /* Projectile Class Declaration
  * - Base class for vomit and flames
  * - All projectiles are not flammable, are destroyed after 2 ticks, and are drawn at a depth of 0
+ * - A projectile only acts on its first tick; a timer destroys it at the start of its second, so it is never visited then
  */
 class Projectile : public Actor {
 public:
@@ -104,11 +140,12 @@ public:
     
     // Mutators
     virtual void doSomething(); // Infect or destroy infectable or destructible actors
+    virtual void timerExpired(); // Destroys the projectile
 protected:
     // Mutators
     virtual void affect() = 0; // Implementation of infection/destruction
 private:
-    int m_ticksLeft; // Number of ticks left until destruction
+    TimerWheel::Timer m_expiry; // Goes off when the projectile is destroyed
 };
 
 // Flame Class Declaration
@@ -116,6 +153,9 @@ class Flame : public Projectile {
 public:
     // Constructor
     Flame(int startX, int startY, Direction startDirection, StudentWorld* stWorld);
+    
+    // Mutators
+    virtual void dispose(); // Flames are returned to the StudentWorld's flame pool
 protected:
     // Mutators
     virtual void affect(); // Destroy destructible actors
@@ -126,6 +166,9 @@ class Vomit : public Projectile {
 public:
     // Constructor
     Vomit(int startX, int startY, Direction startDirection, StudentWorld* stWorld);
+    
+    // Mutators
+    virtual void dispose(); // Vomit is returned to the StudentWorld's vomit pool
 protected:
     // Mutators
     virtual void affect(); // Infect infectable actors
@@ -141,6 +184,9 @@ public:
     // Constructor
     Goodie(int imageID, int startX, int startY, StudentWorld* stWorld);
     
+    // Properties
+    virtual bool trigger() const; // Goodies only act on Penelope picking them up
+    
     // Mutators
     virtual void doSomething(); // Detect if goodie was picked up by Penelope
 protected:
@@ -181,19 +227,23 @@ protected:
 /* Landmine Class Declaration
  * - Landmines are sufficiently different from other actors to merit not having a base class other than Actor
  * - Landmines are drawn with an orientation of right and a depth of 1
- * - Landmines start with 30 safety ticks before becoming active
+ * - Landmines start with 30 safety ticks before becoming active, counted by a timer rather than by the landmine
  */
 class Landmine : public Actor {
 public:
     // Constructor
     Landmine(int startX, int startY, StudentWorld* stWorld);
     
+    // Properties
+    virtual bool trigger() const; // Landmines only act on people stepping on them, once armed
+    
     // Mutators
     virtual void destroy();     // Sets state to dead and creates flames and a pit
     virtual void doSomething(); // Detects whether the landmine has been stepped upon
+    virtual void timerExpired(); // Activates the landmine once its safety ticks are over
 private:
-    int m_safetyTicks;  // Number of safety ticks remaining
-    bool m_active;      // Whether the landmine is active
+    TimerWheel::Timer m_safety; // Goes off when the landmine becomes active
+    bool m_active;              // Whether the landmine is active
 };
 
 /* Person Class Declaration
@@ -211,29 +261,41 @@ public:
     virtual bool pitDestructible() const;   // People can be destroyed by pits
     
     // Accessors
-    int infection() const; // Returns number of ticks this person has been infected
+    int infection() const; // Returns number of ticks this person has been infected, counting only the ticks it has had its turn
     
     // Mutators
     virtual void doSomething(); // Checks if turned into zombie, then call doAction()
     virtual void destroy();     // People play a sound and change Penelope's score when destroyed
     virtual void infect();      // Infects this person
     void resetInfection();      // Uninfects this person
+    virtual void prepare(std::uint64_t seed, std::uint64_t stream); // Runs decide() now, so the next doSomething() only has to act()
+    virtual void timerExpired(); // Marks the infection as having run its course, so this person turns into a zombie on its turn
 protected:
     // Accessors
     bool infected() const; // Returns whether this person is infected
+    bool canMove(Direction dir) const; // Returns whether moving in Direction dir is allowed
     
     // Mutators
-    virtual void doAction() = 0; // Makes this person do some action
-    virtual bool paralyzed(); // Returns whether this person is paralyzed with indecision
+    virtual void doAction(); // Makes this person do some action; default of decide() followed by act()
+    virtual void decide(RandomGenerator& rng); // Works out what act() will do, only reading the rest of the world; default of nothing
+    virtual void act(); // Does what decide() settled on; default of nothing
+    virtual bool paralyzed() const; // Returns whether this person is paralyzed with indecision this tick, which it is every other tick
     bool moveDirection(Direction dir); // Attempts to move in Direction dir, returns whether move was successful
 private:
     bool m_infected;     // Whether this person has been infected by vomit, always false for zombies
-    bool m_paralyzed;    // Whether this person is paralyzed with indecision
-    int m_infection;     // Number of ticks person has been infected, always 0 for zombies
+    bool m_infectionDue; // Whether the infection has run its course and this person turns into a zombie on its next turn
+    bool m_prepared;     // Whether prepare() has already run decide() for this tick
+    long m_born;         // Tick this person was created in; it takes its first turn on the next one
+    long m_lastTurn;     // Last tick this person had its turn (or was created in)
+    long m_infectionStart; // First tick whose turn counts towards the infection
+    TimerWheel::Timer m_infectionTimer; // Goes off at the start of the tick of the infection's 500th turn
     int m_score_value;   // Number of points awarded/deducted when this person is destroyed
     int m_sound_infect;  // Sound to be played when this person is destroyed by infection
     int m_sound_flame;   // Sound to be played when this person is destroyed by flames
     int m_step_distance; // How far this person moves in a single tick
+    
+    // Helper Functions
+    void destination(Direction dir, int& x, int& y) const; // Gets where a step in Direction dir would take this person
 };
 
 /* Penelope Class Declaration
@@ -262,7 +324,7 @@ public:
 protected:
     // Mutators
     virtual void doAction();    // Detects user input and has Penelope act accordingly
-    virtual bool paralyzed();   // Penelope is never paralyzed with indecision!
+    virtual bool paralyzed() const; // Penelope is never paralyzed with indecision!
 private:
     int m_landmines;    // Number of landmines carried by Penelope
     int m_flameCharges; // Number of flamethrower charges carried by Penelope
@@ -285,7 +347,14 @@ public:
     virtual void infect(); // Citizens also play an infection sound when infected
 protected:
     // Mutators
-    virtual void doAction(); // Citizens follow Penelope and run from zombies
+    virtual void decide(RandomGenerator& rng); // Citizens follow Penelope and run from zombies
+    virtual void act(); // Citizens take the step they decided on, if any
+private:
+    bool m_moving;      // Whether this citizen decided to take a step
+    Direction m_step;   // Direction of that step
+    
+    // Mutators
+    bool intendMove(Direction dir); // Decides on a step in Direction dir if it is allowed, returns whether it is
 };
 
 /* Zombie Class Declaration
@@ -300,13 +369,17 @@ public:
     
 protected:
     // Mutators
-    virtual void doAction();        // Zombies have common movement behaviors
-    virtual void movementPlan();    // Zombies create movement plans
+    virtual void decide(RandomGenerator& rng);  // Zombies have common movement behaviors
+    virtual void act();                         // Zombies vomit or move as decided
+    virtual void movementPlan(int& distance, RandomGenerator& rng); // Zombies create movement plans, choosing a direction and possibly shortening the distance
 private:
     int m_movementPlan; // Distance to travel in current direction
+    bool m_vomiting;    // Whether this zombie decided to vomit
+    int m_vomitX;       // Where it will vomit
+    int m_vomitY;
     
     // Mutators
-    bool vomit(); // Zombies will vomit on nearby people
+    bool vomit(RandomGenerator& rng); // Zombies will vomit on nearby people; returns whether this one decided to
 };
 
 /* Smart Zombie Class Declaration
@@ -319,9 +392,12 @@ class SmartZombie : public Zombie {
 public:
     // Constructor
     SmartZombie(int startX, int startY, StudentWorld* stWorld);
+    
+    // Properties
+    virtual bool smart() const; // Smart zombies find their way around walls
 protected:
     // Mutators
-    virtual void movementPlan(); // Smart zombies have a different way of creating movement plans
+    virtual void movementPlan(int& distance, RandomGenerator& rng); // Smart zombies have a different way of creating movement plans
 };
 
 #endif // ACTOR_H_
@@ -0,0 +1,133 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <vector>
+#include <new>
+#include <cstddef>
+#include <cassert>
+
+  // A bump allocator for objects of assorted sizes: allocate() hands out
+  // memory from large blocks, and release() puts an allocation on a free
+  // list for its size, for the next allocate() of that size to reuse.
+  // reset() rewinds to the start of the first block once everything has
+  // been released; the arena never destroys anything itself, so objects
+  // must be destroyed before they are released.  The blocks are kept after
+  // a reset, so an arena that is reset and filled again no longer touches
+  // the heap.
+
+class Arena
+{
+public:
+
+    Arena()
+     : m_block(0), m_offset(0), m_bytesUsed(0), m_live(0)
+    {
+    }
+
+    ~Arena()
+    {
+        for (size_t k = 0; k < m_blocks.size(); k++)
+            ::operator delete(m_blocks[k].memory);
+    }
+
+    void* allocate(size_t size)
+    {
+        size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        m_bytesUsed += size;
+        m_live++;
+        size_t sizeClass = size / ALIGNMENT;
+        if (sizeClass < m_free.size()  &&  m_free[sizeClass] != nullptr)
+        {
+            void* p = m_free[sizeClass];
+            m_free[sizeClass] = *static_cast<void**>(p);
+            return p;
+        }
+
+          // Each allocation is preceded by its size, so release() knows
+          // which free list it goes on
+        size_t total = HEADER + size;
+        while (m_block < m_blocks.size()  &&  m_offset + total > m_blocks[m_block].size)
+        {
+            m_block++;
+            m_offset = 0;
+        }
+        if (m_block == m_blocks.size())
+        {
+            Block b;
+            b.size = total > BLOCK_SIZE ? total : BLOCK_SIZE;
+            b.memory = static_cast<char*>(::operator new(b.size));
+            m_blocks.push_back(b);
+        }
+        char* p = m_blocks[m_block].memory + m_offset;
+        m_offset += total;
+        *reinterpret_cast<size_t*>(p) = size;
+        return p + HEADER;
+    }
+
+      // Makes the memory of an object from allocate(), which must already
+      // have been destroyed, available to later allocations of its size
+    void release(void* p)
+    {
+        size_t size = *reinterpret_cast<size_t*>(static_cast<char*>(p) - HEADER);
+        size_t sizeClass = size / ALIGNMENT;
+        if (sizeClass >= m_free.size())
+            m_free.resize(sizeClass + 1, nullptr);
+        *static_cast<void**>(p) = m_free[sizeClass];
+        m_free[sizeClass] = p;
+        m_bytesUsed -= size;
+        m_live--;
+    }
+
+      // Starts allocating from the first block again; everything allocated
+      // must have been released
+    void reset()
+    {
+        assert(m_live == 0);
+        m_block = 0;
+        m_offset = 0;
+        m_bytesUsed = 0;
+        m_live = 0;
+        m_free.clear();
+    }
+
+      // The number of bytes allocated and not yet released
+    size_t bytesUsed() const
+    {
+        return m_bytesUsed;
+    }
+
+    size_t capacity() const
+    {
+        size_t total = 0;
+        for (size_t k = 0; k < m_blocks.size(); k++)
+            total += m_blocks[k].size;
+        return total;
+    }
+
+      // Prevent copying or assigning Arenas
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+private:
+
+    static const size_t BLOCK_SIZE = 64 * 1024;
+    static const size_t ALIGNMENT = alignof(std::max_align_t);
+    static const size_t HEADER = ALIGNMENT;     // keeps what follows aligned
+
+    struct Block
+    {
+        char*  memory;
+        size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_block;         // block currently being filled
+    size_t m_offset;        // first free byte in that block
+    size_t m_bytesUsed;
+    size_t m_live;          // allocations not yet released
+    std::vector<void*> m_free;  // released allocations of each size, as
+                                // lists linked through their first bytes,
+                                // indexed by size / ALIGNMENT
+};
+
+#endif // ARENA_H_
@@ -0,0 +1,159 @@
+#include "DistanceField.h"
+#include "DistanceKernels.h"
+#include "Actor.h"
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+// Constructor
+DistanceField::DistanceField(int width, int height, int resolution) : m_resolution(resolution), m_cols(max((width + resolution - 1) / resolution, 1)), m_rows(max((height + resolution - 1) / resolution, 1)), m_buckets(m_cols * m_rows) {}
+
+// Mutators
+void DistanceField::insert(const Actor* site) {
+    m_x.push_back(site->getX());
+    m_y.push_back(site->getY());
+    m_site.push_back(site);
+    addAt(m_buckets[cellIndex(site->getX(), site->getY())], m_site.size() - 1);
+}
+
+void DistanceField::move(const Actor* site, double oldX, double oldY) {
+    Bucket& from = m_buckets[cellIndex(oldX, oldY)];
+    int i = find(from, site);
+    if (i < 0) return;
+    int slot = from.slot[i];
+    m_x[slot] = site->getX();
+    m_y[slot] = site->getY();
+    Bucket& to = m_buckets[cellIndex(site->getX(), site->getY())];
+    // Most moves stay within a cell, where the site only needs its position updated
+    if (&to == &from) {
+        from.x[i] = site->getX();
+        from.y[i] = site->getY();
+        return;
+    }
+    removeAt(from, i);
+    addAt(to, slot);
+}
+
+void DistanceField::remove(const Actor* site) {
+    Bucket& bucket = m_buckets[cellIndex(site->getX(), site->getY())];
+    int i = find(bucket, site);
+    if (i < 0) return;
+    int slot = bucket.slot[i];
+    removeAt(bucket, i);
+    // Fill the slot with the last site, and tell that site's bucket where it went
+    int last = m_site.size() - 1;
+    if (slot != last) {
+        m_x[slot] = m_x[last];
+        m_y[slot] = m_y[last];
+        m_site[slot] = m_site[last];
+        Bucket& moved = m_buckets[cellIndex(m_x[slot], m_y[slot])];
+        moved.slot[find(moved, m_site[slot])] = slot;
+    }
+    m_x.pop_back();
+    m_y.pop_back();
+    m_site.pop_back();
+}
+
+void DistanceField::clear() {
+    for (int i = 0; i < m_buckets.size(); i++) {
+        m_buckets[i].x.clear();
+        m_buckets[i].y.clear();
+        m_buckets[i].site.clear();
+        m_buckets[i].slot.clear();
+    }
+    m_x.clear();
+    m_y.clear();
+    m_site.clear();
+}
+
+// Accessors
+bool DistanceField::nearest(double x, double y, double maxDistance, double& dist) const {
+    int c = col(x);
+    int r = row(y);
+    // Nothing farther than maxDistance counts, so start as if there were a site that far away
+    double best = maxDistance * maxDistance;
+    bool found = false;
+    if (m_site.size() <= SCAN_ALL_SITES) {
+        double d;
+        if (nearestPosition(m_x.data(), m_y.data(), m_site.size(), x, y, d) != -1 && d <= best) {
+            best = d;
+            found = true;
+        }
+    }
+    else {
+        for (int ring = 0; ; ring++) {
+            double bound = ringBound(x, y, ring);
+            if (bound < 0 || bound * bound > best) break;
+            for (int j = r - ring; j <= r + ring; j++) {
+                if (j < 0 || j >= m_rows) continue;
+                // Rows at the top and bottom of the ring are visited in full, all others only at their two ends
+                int step = (j == r - ring || j == r + ring) ? 1 : 2*ring;
+                for (int i = c - ring; i <= c + ring; i += step) {
+                    if (i < 0 || i >= m_cols) continue;
+                    const Bucket& bucket = m_buckets[j*m_cols + i];
+                    double d;
+                    if (nearestPosition(bucket.x.data(), bucket.y.data(), bucket.x.size(), x, y, d) != -1 && d <= best) {
+                        best = d;
+                        found = true;
+                    }
+                }
+            }
+        }
+    }
+    if (!found) return false;
+    dist = sqrt(best);
+    return true;
+}
+
+// Helper Functions
+int DistanceField::col(double x) const {
+    int c = static_cast<int>(floor(x / m_resolution));
+    return c < 0 ? 0 : (c >= m_cols ? m_cols - 1 : c);
+}
+
+int DistanceField::row(double y) const {
+    int r = static_cast<int>(floor(y / m_resolution));
+    return r < 0 ? 0 : (r >= m_rows ? m_rows - 1 : r);
+}
+
+int DistanceField::cellIndex(double x, double y) const {return row(y)*m_cols + col(x);}
+
+int DistanceField::find(const Bucket& bucket, const Actor* site) const {
+    for (int i = 0; i < bucket.site.size(); i++)
+        if (bucket.site[i] == site) return i;
+    return -1;
+}
+
+void DistanceField::removeAt(Bucket& bucket, int i) {
+    // Order within a bucket does not matter, so swap with the last site instead of shifting
+    bucket.x[i] = bucket.x.back();
+    bucket.y[i] = bucket.y.back();
+    bucket.site[i] = bucket.site.back();
+    bucket.slot[i] = bucket.slot.back();
+    bucket.x.pop_back();
+    bucket.y.pop_back();
+    bucket.site.pop_back();
+    bucket.slot.pop_back();
+}
+
+void DistanceField::addAt(Bucket& bucket, int slot) {
+    bucket.x.push_back(m_x[slot]);
+    bucket.y.push_back(m_y[slot]);
+    bucket.site.push_back(m_site[slot]);
+    bucket.slot.push_back(slot);
+}
+
+double DistanceField::ringBound(double x, double y, int ring) const {
+    if (ring == 0) return 0;
+    int c = col(x);
+    int r = row(y);
+    // Every cell of the ring lies in its leftmost or rightmost column or its top or bottom row, so a site there is at
+    // least as far from (x, y) as the nearest of those lines that are inside the field; sites clamped into an edge cell
+    // lie beyond it, which only makes them farther
+    double bound = HUGE_VAL;
+    if (c - ring >= 0) bound = min(bound, x - (c - ring + 1) * m_resolution);
+    if (c + ring < m_cols) bound = min(bound, (c + ring) * m_resolution - x);
+    if (r - ring >= 0) bound = min(bound, y - (r - ring + 1) * m_resolution);
+    if (r + ring < m_rows) bound = min(bound, (r + ring) * m_resolution - y);
+    return bound == HUGE_VAL ? -1 : bound;
+}
@@ -0,0 +1,57 @@
+#ifndef DISTANCEFIELD_H_
+#define DISTANCEFIELD_H_
+
+#include <vector>
+
+class Actor;
+
+/* DistanceField Class Declaration
+ * - Gives the exact distance from any point to the nearest of a set of sites (actors), wherever the sites are at the time
+ * - Sites are bucketed by square cell of a fixed resolution, and are added, moved and removed as they come, go and move
+ * - All sites' coordinates are also packed into one pair of x and y arrays, and each bucket's into its own pair, for the distance kernels
+ * - A lookup among only a few sites runs the kernel over all of them at once; otherwise it searches outwards one ring of cells at a
+ *   time, running the kernel over each bucket, and stops once no site in a further ring could be nearer or in range
+ * - Positions outside of the field are clamped to the nearest edge cell
+ */
+class DistanceField {
+public:
+    // Constructor
+    DistanceField(int width, int height, int resolution); // Creates an empty field covering width x height pixels with cells of resolution x resolution pixels
+
+    // Mutators
+    void insert(const Actor* site);                               // Adds site at its position
+    void move(const Actor* site, double oldX, double oldY);       // Moves site from (oldX, oldY) to its position
+    void remove(const Actor* site);                               // Removes site from its position
+    void clear();                                                 // Removes all sites
+
+    // Accessors
+    bool nearest(double x, double y, double maxDistance, double& dist) const; // Gets the distance from (x, y) to the nearest site; returns false if no site is within maxDistance of it
+    int sites() const {return m_site.size();} // Returns the number of sites
+private:
+    static const int SCAN_ALL_SITES = 96; // Up to this many sites, checking every one beats searching ring by ring
+    // The sites in one cell, in no particular order
+    struct Bucket {
+        std::vector<double> x;              // Positions of the sites
+        std::vector<double> y;
+        std::vector<const Actor*> site;     // The sites themselves
+        std::vector<int> slot;              // Index of each site in m_x, m_y and m_site
+    };
+    int m_resolution; // Width and height of a cell, in pixels
+    int m_cols; // Number of columns of cells
+    int m_rows; // Number of rows of cells
+    std::vector<Bucket> m_buckets; // Sites in each cell, stored row by row
+    std::vector<double> m_x;          // Positions of all sites, in no particular order
+    std::vector<double> m_y;
+    std::vector<const Actor*> m_site; // All sites
+
+    // Helper Functions
+    int col(double x) const; // Returns the column of the cell containing x, clamped to the field
+    int row(double y) const; // Returns the row of the cell containing y, clamped to the field
+    int cellIndex(double x, double y) const; // Returns the index of the bucket containing (x, y)
+    int find(const Bucket& bucket, const Actor* site) const; // Returns the index of site in bucket, or -1
+    void removeAt(Bucket& bucket, int i); // Removes the i-th site of bucket, but not from m_x, m_y and m_site
+    void addAt(Bucket& bucket, int slot); // Adds the site in slot of m_x, m_y and m_site to bucket
+    double ringBound(double x, double y, int ring) const; // Returns how near to (x, y) a site ring cells or more away from its cell may be, or -1 if no cells are that far
+};
+
+#endif // DISTANCEFIELD_H_
@@ -0,0 +1,72 @@
+#include "DistanceKernels.h"
+#include <limits>
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+int nearestPositionScalar(const double* xs, const double* ys, int count, double x, double y, double& distSquared) {
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+        double d = (xs[i] - x)*(xs[i] - x) + (ys[i] - y)*(ys[i] - y);
+        if (best == -1 || d < distSquared) {
+            best = i;
+            distSquared = d;
+        }
+    }
+    return best;
+}
+
+int nearestPosition(const double* xs, const double* ys, int count, double x, double y, double& distSquared) {
+#if defined(__AVX__) || defined(__SSE2__)
+    int i = 0;
+    double min;
+#endif
+#if defined(__AVX__)
+    if (count < 4) return nearestPositionScalar(xs, ys, count, x, y, distSquared);
+    // Find the smallest squared distance four lanes at a time
+    __m256d px = _mm256_set1_pd(x);
+    __m256d py = _mm256_set1_pd(y);
+    __m256d mins = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    for (; i + 4 <= count; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), px);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), py);
+        mins = _mm256_min_pd(mins, _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, mins);
+    min = lanes[0];
+    for (int k = 1; k < 4; k++)
+        if (lanes[k] < min) min = lanes[k];
+#elif defined(__SSE2__)
+    if (count < 2) return nearestPositionScalar(xs, ys, count, x, y, distSquared);
+    // Find the smallest squared distance two lanes at a time
+    __m128d px = _mm_set1_pd(x);
+    __m128d py = _mm_set1_pd(y);
+    __m128d mins = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    for (; i + 2 <= count; i += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), px);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), py);
+        mins = _mm_min_pd(mins, _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, mins);
+    min = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+#endif
+#if defined(__AVX__) || defined(__SSE2__)
+    // Finish off the positions that did not fill a whole vector
+    for (int k = i; k < count; k++) {
+        double d = (xs[k] - x)*(xs[k] - x) + (ys[k] - y)*(ys[k] - y);
+        if (d < min) min = d;
+    }
+    // The first position at the smallest distance is the one the plain loop would pick
+    for (int k = 0; k < count; k++) {
+        if ((xs[k] - x)*(xs[k] - x) + (ys[k] - y)*(ys[k] - y) == min) {
+            distSquared = min;
+            return k;
+        }
+    }
+    return -1;
+#else
+    return nearestPositionScalar(xs, ys, count, x, y, distSquared);
+#endif
+}
@@ -0,0 +1,17 @@
+#ifndef DISTANCEKERNELS_H_
+#define DISTANCEKERNELS_H_
+
+/* Distance Kernels
+ * - Batch distance computations over positions packed into separate x and y arrays
+ * - Uses AVX or SSE2 when the compiler targets them, and plain loops otherwise
+ * - Positions are whole pixels, so every squared distance is exact in a double and all paths give identical results
+ */
+
+// Returns the index of the position (xs[i], ys[i]) nearest to (x, y), or -1 if count is 0, and sets distSquared to its
+// squared distance.  Ties go to the lowest index.
+int nearestPosition(const double* xs, const double* ys, int count, double x, double y, double& distSquared);
+
+// Same as nearestPosition(), but always uses the plain loop
+int nearestPositionScalar(const double* xs, const double* ys, int count, double x, double y, double& distSquared);
+
+#endif // DISTANCEKERNELS_H_
@@ -0,0 +1,109 @@
+#include "FlowField.h"
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+using namespace std;
+
+// Constructor
+FlowField::FlowField(int width, int height) : m_cols(max((width + SPRITE_WIDTH - 1) / SPRITE_WIDTH, 1)), m_rows(max((height + SPRITE_HEIGHT - 1) / SPRITE_HEIGHT, 1)), m_maxSteps(0), m_blocked(m_cols * m_rows, false), m_steps(m_cols * m_rows, -1), m_nearest(m_cols * m_rows, 0) {}
+
+// Mutators
+void FlowField::setBlocked(double x, double y) {
+    m_blocked[cellIndex(x, y)] = true;
+    invalidate();
+}
+
+void FlowField::invalidate() {m_sourceCells.clear();}
+
+void FlowField::clear() {
+    fill(m_blocked.begin(), m_blocked.end(), false);
+    for (int i = 0; i < m_reached.size(); i++)
+        m_steps[m_reached[i]] = -1;
+    m_reached.clear();
+    m_sourceCells.clear();
+    m_sourceX.clear();
+    m_sourceY.clear();
+}
+
+void FlowField::build(const vector<int>& sourceX, const vector<int>& sourceY, int maxSteps) {
+    vector<int> sourceCells(sourceX.size());
+    for (int i = 0; i < sourceX.size(); i++)
+        sourceCells[i] = cellIndex(sourceX[i], sourceY[i]);
+    m_sourceX = sourceX;
+    m_sourceY = sourceY;
+    // Nothing has moved into another cell, so the distances are still right
+    if (sourceCells == m_sourceCells && maxSteps == m_maxSteps && !sourceCells.empty()) return;
+    m_sourceCells = sourceCells;
+    m_maxSteps = maxSteps;
+
+    for (int i = 0; i < m_reached.size(); i++)
+        m_steps[m_reached[i]] = -1;
+    m_reached.clear();
+
+    // Multi-source breadth-first search; m_reached doubles as the queue
+    for (int i = 0; i < sourceCells.size(); i++) {
+        int cell = sourceCells[i];
+        if (m_steps[cell] != -1) continue;
+        m_steps[cell] = 0;
+        m_nearest[cell] = i;
+        m_reached.push_back(cell);
+    }
+    for (int head = 0; head < m_reached.size(); head++) {
+        int cell = m_reached[head];
+        if (m_steps[cell] == maxSteps) continue;
+        int c = cell % m_cols;
+        int r = cell / m_cols;
+        int neighbors[4] = {c + 1 < m_cols ? cell + 1 : -1, c > 0 ? cell - 1 : -1, r + 1 < m_rows ? cell + m_cols : -1, r > 0 ? cell - m_cols : -1};
+        for (int k = 0; k < 4; k++) {
+            int next = neighbors[k];
+            if (next < 0 || m_blocked[next] || m_steps[next] != -1) continue;
+            m_steps[next] = m_steps[cell] + 1;
+            m_nearest[next] = m_nearest[cell];
+            m_reached.push_back(next);
+        }
+    }
+}
+
+// Accessors
+bool FlowField::lookup(double x, double y, int& steps, Direction& dir, int& sourceX, int& sourceY) const {
+    int cell = cellIndex(x, y);
+    steps = m_steps[cell];
+    if (steps == -1) return false;
+    sourceX = m_sourceX[m_nearest[cell]];
+    sourceY = m_sourceY[m_nearest[cell]];
+    if (steps == 0) return true;
+
+    // Step to a neighbor one closer, preferring the axis along which the source is farther away
+    int c = cell % m_cols;
+    int r = cell / m_cols;
+    int dx = sourceX - c*SPRITE_WIDTH;
+    int dy = sourceY - r*SPRITE_HEIGHT;
+    bool horizontalFirst = abs(dx) >= abs(dy);
+    int order[4][3] = {
+        {c + 1 < m_cols ? cell + 1 : -1, GraphObject::right, dx > 0},
+        {c > 0 ? cell - 1 : -1, GraphObject::left, dx < 0},
+        {r + 1 < m_rows ? cell + m_cols : -1, GraphObject::up, dy > 0},
+        {r > 0 ? cell - m_cols : -1, GraphObject::down, dy < 0}
+    };
+    int best = -1, bestScore = -1;
+    for (int k = 0; k < 4; k++) {
+        int next = order[k][0];
+        if (next < 0 || m_steps[next] != steps - 1) continue;
+        int score = (order[k][2] ? 2 : 0) + ((k < 2) == horizontalFirst ? 1 : 0);
+        if (score > bestScore) {
+            best = k;
+            bestScore = score;
+        }
+    }
+    dir = order[best][1];
+    return true;
+}
+
+// Helper Functions
+int FlowField::cellIndex(double x, double y) const {
+    int c = static_cast<int>(floor((x + SPRITE_WIDTH/2) / SPRITE_WIDTH));
+    int r = static_cast<int>(floor((y + SPRITE_HEIGHT/2) / SPRITE_HEIGHT));
+    c = c < 0 ? 0 : (c >= m_cols ? m_cols - 1 : c);
+    r = r < 0 ? 0 : (r >= m_rows ? m_rows - 1 : r);
+    return r*m_cols + c;
+}
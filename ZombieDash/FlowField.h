@@ -0,0 +1,43 @@
+#ifndef FLOWFIELD_H_
+#define FLOWFIELD_H_
+
+#include "GameConstants.h"
+#include "GraphObject.h"
+#include <vector>
+
+/* FlowField Class Declaration
+ * - Breadth-first distances, in SPRITE_WIDTH x SPRITE_HEIGHT cells, from every cell to the nearest of a set of sources
+ * - Cells can be blocked (by walls), and paths only go through unblocked cells in the four directions actors move in
+ * - The search stops a fixed number of steps out, so the cost of a build depends on the number of sources, not on the size of the map
+ * - Rebuilding with sources in the same cells as last time only updates their positions
+ */
+class FlowField {
+public:
+    // Constructor
+    FlowField(int width, int height); // Creates a field with no blocked cells covering width x height pixels
+
+    // Mutators
+    void setBlocked(double x, double y);    // Blocks the cell containing (x, y)
+    void clear();                           // Unblocks all cells and removes all sources
+    void build(const std::vector<int>& sourceX, const std::vector<int>& sourceY, int maxSteps); // Recomputes the field for sources at the given positions
+    void invalidate();                      // Makes the next build search again, even if no source has changed cells
+
+    // Accessors
+    bool lookup(double x, double y, int& steps, Direction& dir, int& sourceX, int& sourceY) const; // For the cell nearest (x, y), gets the steps to the nearest source, the direction of the first step (if any), and the position of that source; returns false if no source is within maxSteps
+private:
+    int m_cols; // Number of columns of cells
+    int m_rows; // Number of rows of cells
+    int m_maxSteps;                 // Search depth of the last build
+    std::vector<bool> m_blocked;    // Whether each cell is blocked, stored row by row
+    std::vector<int> m_steps;       // Steps from each cell to its nearest source, or -1 if none is within m_maxSteps
+    std::vector<int> m_nearest;     // Index of the nearest source of each cell
+    std::vector<int> m_reached;     // Cells with m_steps set by the last build, so the next build only resets those
+    std::vector<int> m_sourceCells; // Cells of the sources of the last build, in order
+    std::vector<int> m_sourceX;     // Positions of the sources of the last build
+    std::vector<int> m_sourceY;
+
+    // Helper Functions
+    int cellIndex(double x, double y) const; // Returns the index of the cell nearest to (x, y), clamped to the field
+};
+
+#endif // FLOWFIELD_H_
@@ -1,9 +1,6 @@
 #ifndef GAMECONSTANTS_H_
 #define GAMECONSTANTS_H_
 
-#include <random>
-#include <utility>
-
 // IDs for the game objects
 
 const int IID_PLAYER               =  0;
@@ -55,9 +52,12 @@ const int VIEW_HEIGHT = 256;
 const int SPRITE_WIDTH = 16;
 const int SPRITE_HEIGHT = 16;
 
-const int LEVEL_WIDTH = VIEW_WIDTH / SPRITE_WIDTH;
+const int LEVEL_WIDTH = VIEW_WIDTH / SPRITE_WIDTH;     // size of a level that does not give one
 const int LEVEL_HEIGHT = VIEW_HEIGHT / SPRITE_HEIGHT;
 
+const int MAX_LEVEL_WIDTH = 2048;   // largest level, in cells (32768 pixels); squared distances
+const int MAX_LEVEL_HEIGHT = 2048;  // across it approach 2 * 32768^2 = 2^31, so they are long longs
+
 const double SPRITE_WIDTH_GL = .6; // note - this is tied implicitly to SPRITE_WIDTH due to carey's sloppy openGL programming
 const double SPRITE_HEIGHT_GL = .5; // note - this is tied implicitly to SPRITE_HEIGHT due to carey's sloppy openGL programming
 
@@ -70,18 +70,4 @@ const int GWSTATUS_PLAYER_WON    = 2;
 const int GWSTATUS_FINISHED_LEVEL= 3;
 const int GWSTATUS_LEVEL_ERROR   = 4;
 
-
-  // Return a uniformly distributed random int from min to max, inclusive
-
-inline
-int randInt(int min, int max)
-{
-    if (max < min)
-        std::swap(max, min);
-    static std::random_device rd;
-    static std::mt19937 generator(rd());
-    std::uniform_int_distribution<> distro(min, max);
-    return distro(generator);
-}
-
 #endif // GAMECONSTANTS_H_
@@ -5,6 +5,9 @@
 #include "GraphObject.h"
 #include "SoundFX.h"
 #include "SpriteManager.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include <iostream>
 #include <string>
 #include <map>
 #include <utility>
@@ -51,7 +54,7 @@ struct SpriteInfo
 };
 
 static void drawPrompt(string mainMessage, string secondMessage);
-static void drawScoreAndLives(string);
+static void drawScoreAndLives(string, RandomGenerator&);
 
 enum GameController::GameControllerState : int {
     welcome, init, makemove, animate, contgame, finishedlevel, cleanup,
@@ -102,6 +105,8 @@ void GameController::initDrawersAndSounds()
         if (!m_spriteManager.loadSprite(path + d.tgaFileName, d.imageID, d.frameNum))
             exit(1);
     }
+    if (!m_spriteManager.buildAtlas())
+        exit(1);
     for (const auto& s : sounds)
         m_soundMap[s.first] = s.second;
 }
@@ -135,6 +140,7 @@ static void timerFuncCallback(int)
 void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTitle)
 {
     gw->setController(this);
+    gw->setRecorder(m_recorder);
     m_gw = gw;
     setGameState(welcome);
     m_lastKeyHit = INVALID_KEY;
@@ -159,6 +165,9 @@ void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTit
 
     glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
     glutMainLoop();
+    if (m_recorder != nullptr)
+        m_recorder->close();
+    PROFILE_REPORT(cerr);
     delete m_gw;
 }
 
@@ -174,6 +183,9 @@ void GameController::keyboardEvent(unsigned char key, int /* x */, int /* y */)
         case 'f':           m_singleStep = true;            break;
         case 'r':           m_singleStep = false;           break;
         case 'q': case 'Q': quitGame();                     break;
+#ifdef ZOMBIEDASH_PROFILE
+        case 'p':           PROFILE_REPORT(cerr);           break;
+#endif
         default:            m_lastKeyHit = key;             break;
     }
 }
@@ -225,6 +237,7 @@ void GameController::quitGame()
 
 void GameController::doSomething()
 {
+    PROFILE_PHASE("GameController::doSomething");
     switch (m_gameState)
     {
         case not_applicable:
@@ -249,7 +262,11 @@ void GameController::doSomething()
                         "Press Enter to quit...");
                 }
                 else
+                {
+                    if (m_recorder != nullptr)
+                        m_recorder->levelStarted(m_gw->getLevel());
                     setGameState(makemove);
+                }
             }
             break;
         case makemove:
@@ -257,6 +274,8 @@ void GameController::doSomething()
             m_nextStateAfterAnimate = not_applicable;
             {
                 int status = m_gw->move();
+                if (m_recorder != nullptr)
+                    m_recorder->tickEnded();
                 if (status == GWSTATUS_PLAYER_DIED)
                 {
                       // animate one last frame so the player can see what happened
@@ -321,29 +340,69 @@ void GameController::doSomething()
     }
 }
 
+  // Where along one axis a view of viewSize pixels centered on target
+  // starts, kept inside a world of worldSize pixels where it fits; a world
+  // smaller than the view is centered in it instead
+
+static double viewOrigin(double target, int viewSize, int worldSize)
+{
+    if (worldSize < viewSize)
+        return (worldSize - viewSize) / 2.0;
+    double origin = target - viewSize / 2.0;
+    if (origin > worldSize - viewSize)
+        origin = worldSize - viewSize;
+    if (origin < 0)
+        origin = 0;
+    return origin;
+}
+
 void GameController::displayGamePlay()
 {
-    glEnable(GL_DEPTH_TEST); // must be done each time before displaying graphics or gets disabled for some reason
-    glLoadIdentity();
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    {
+        PROFILE_PHASE("displayGamePlay");
+        glEnable(GL_DEPTH_TEST); // must be done each time before displaying graphics or gets disabled for some reason
+        glLoadIdentity();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 #ifdef _MSC_VER
-    gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
+        gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
 #else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-    gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
+        gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
 #pragma GCC diagnostic pop
 #endif
 
-    GraphObject::drawAllObjects(
-        [=](int imageID, int animationNumber, double x, double y, int angle, double size)
-        {
-            int frame = animationNumber % m_spriteManager.getNumFrames(imageID);
-            m_spriteManager.plotSprite(imageID, frame, x, y, angle, size);
-        });
+          // Center the view on the camera target, but keep it inside the
+          // world.  The viewport has the screen's shape (main() sees to
+          // that), so sprites are scaled the same along both axes.
+        int worldWidth, worldHeight;
+        double targetX, targetY;
+        m_gw->getWorldSize(worldWidth, worldHeight);
+        m_gw->getCameraTarget(targetX, targetY);
+        double viewX = viewOrigin(targetX, m_viewWidth, worldWidth);
+        double viewY = viewOrigin(targetY, m_viewHeight, worldHeight);
+        double scaleX = double(VIEW_WIDTH) / m_viewWidth;
+        double scaleY = double(VIEW_HEIGHT) / m_viewHeight;
+
+          // Only draw what is in view, allowing for sprites reaching past
+          // their positions, with one draw call per depth
+        const double margin = 2 * SPRITE_WIDTH;
+        m_gw->renderList().draw(viewX - margin, viewY - margin, viewX + m_viewWidth + margin, viewY + m_viewHeight + margin,
+            [=](int imageID, int animationNumber, double x, double y, int angle, double size)
+            {
+                int frame = animationNumber % m_spriteManager.getNumFrames(imageID);
+                m_spriteManager.addSprite(imageID, frame, (x - viewX) * scaleX, (y - viewY) * scaleY, angle, size * scaleX);
+            },
+            [this]()
+            {
+                m_spriteManager.drawBatch();
+            });
 
-    drawScoreAndLives(m_gameStatText);
+        drawScoreAndLives(m_gameStatText, m_gw->cosmeticRandom());
+    }
 
+      // The swap waits for the frame to be drawn, so it gets its own phase
+    PROFILE_PHASE("glutSwapBuffers");
     glutSwapBuffers();
 }
 
@@ -402,14 +461,16 @@ static void drawPrompt(string mainMessage, string secondMessage)
     glutSwapBuffers();
 }
 
-static void drawScoreAndLives(string gameStatText)
+static void drawScoreAndLives(string gameStatText, RandomGenerator& rng)
 {
     static int RATE = 1;
     static GLfloat rgb[3] =
         { static_cast<GLfloat>(.6), static_cast<GLfloat>(.6), static_cast<GLfloat>(.6) };
+    int flicker[3];
+    rng.randInts(-RATE, RATE, flicker, 3);
     for (int k = 0; k < 3; k++)
     {
-        double strength = rgb[k] + randInt(-RATE, RATE) / 100.0;
+        double strength = rgb[k] + flicker[k] / 100.0;
         if (strength < .6)
             strength = .6;
         else if (strength > 1.0)
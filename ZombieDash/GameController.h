@@ -2,6 +2,7 @@
 #define GAMECONTROLLER_H_
 
 #include "SpriteManager.h"
+#include "GameWorld.h"
 #include <string>
 #include <map>
 #include <iostream>
@@ -10,14 +11,29 @@
 const int INVALID_KEY = 0;
 
 class GraphObject;
-class GameWorld;
+class ReplayRecorder;
 
-class GameController
+class GameController : public WorldController
 {
   public:
     void run(int argc, char* argv[], GameWorld* gw, std::string windowTitle);
 
-    bool getLastKey(int& value)
+      // Record the session to a replay file (must be called before run())
+    void setRecorder(ReplayRecorder* recorder)
+    {
+        m_recorder = recorder;
+    }
+
+      // Show a viewWidth x viewHeight pixel window of the world, following
+      // the world's camera target, scaled to fill the screen (must be called
+      // before run(), and have the same shape as VIEW_WIDTH x VIEW_HEIGHT)
+    void setViewport(int viewWidth, int viewHeight)
+    {
+        m_viewWidth = viewWidth;
+        m_viewHeight = viewHeight;
+    }
+
+    virtual bool getLastKey(int& value)
     {
         if (m_lastKeyHit != INVALID_KEY)
         {
@@ -28,9 +44,9 @@ class GameController
         return false;
     }
 
-    void playSound(int soundID);
+    virtual void playSound(int soundID);
 
-    void setGameStatText(std::string text)
+    virtual void setGameStatText(std::string text)
     {
         m_gameStatText = text;
     }
@@ -41,7 +57,7 @@ class GameController
     void keyboardEvent(unsigned char key, int x, int y);
     void specialKeyboardEvent(int key, int x, int y);
 
-    void quitGame();
+    virtual void quitGame();
 
       // Meyers singleton pattern
     static GameController& getInstance()
@@ -54,6 +70,7 @@ private:
     enum GameControllerState : int;
 
     GameWorld*          m_gw;
+    ReplayRecorder*     m_recorder = nullptr;
     GameControllerState m_gameState;
     GameControllerState m_nextStateAfterPrompt;
     GameControllerState m_nextStateAfterAnimate;
@@ -68,6 +85,8 @@ private:
     SoundMapType  m_soundMap;
     bool          m_playerWon;
     SpriteManager m_spriteManager;
+    int           m_viewWidth = VIEW_WIDTH;
+    int           m_viewHeight = VIEW_HEIGHT;
 
     void setGameState(GameControllerState s);
     void setGameStateAfterPrompting(GameControllerState s,
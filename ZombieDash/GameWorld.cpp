@@ -1,5 +1,5 @@
 #include "GameWorld.h"
-#include "GameController.h"
+#include "Replay.h"
 #include <string>
 #include <cstdlib>
 using namespace std;
@@ -7,6 +7,8 @@ using namespace std;
 bool GameWorld::getKey(int& value)
 {
     bool gotKey = m_controller->getLastKey(value);
+    if (gotKey  &&  m_recorder != nullptr)
+        m_recorder->keyReturned(value);
 
     if (gotKey)
     {
@@ -2,11 +2,31 @@
 #define GAMEWORLD_H_
 
 #include "GameConstants.h"
+#include "GraphObject.h"
+#include "RandomGenerator.h"
 #include <string>
+#include <cstdint>
+#include <random>
 
 const int START_PLAYER_LIVES = 3;
 
-class GameController;
+  // What a GameWorld needs from whatever is driving it: the windowed
+  // GameController, or a headless driver that runs without GLUT
+
+class ReplayRecorder;
+
+class WorldController
+{
+public:
+    virtual ~WorldController()
+    {
+    }
+
+    virtual bool getLastKey(int& value) = 0;
+    virtual void playSound(int soundID) = 0;
+    virtual void setGameStatText(std::string text) = 0;
+    virtual void quitGame() = 0;
+};
 
 class GameWorld
 {
@@ -14,8 +34,10 @@ public:
 
     GameWorld(std::string assetPath)
      : m_lives(START_PLAYER_LIVES), m_score(0), m_level(1),
-       m_controller(nullptr), m_assetPath(assetPath)
+       m_controller(nullptr), m_recorder(nullptr), m_assetPath(assetPath)
     {
+        std::random_device rd;
+        setSeed((static_cast<std::uint64_t>(rd()) << 32) | rd());
     }
 
     virtual ~GameWorld()
@@ -26,6 +48,19 @@ public:
     virtual int move() = 0;
     virtual void cleanUp() = 0;
 
+      // Lets the world spread its work over this many threads; by default
+      // everything runs on the calling thread
+    virtual void setThreads(int /* threads */)
+    {
+    }
+
+      // Extra lines (if any) about the world's internals for drivers to
+      // report, e.g. at the end of a headless run
+    virtual std::string statsText() const
+    {
+        return "";
+    }
+
     void setGameStatText(std::string text);
 
     bool getKey(int& value);
@@ -65,6 +100,59 @@ public:
     {
         return m_assetPath;
     }
+
+      // The size of the world in pixels, and the point the camera follows;
+      // by default the world is one screen, which the camera always shows
+    virtual void getWorldSize(int& width, int& height) const
+    {
+        width = VIEW_WIDTH;
+        height = VIEW_HEIGHT;
+    }
+
+    virtual void getCameraTarget(double& x, double& y) const
+    {
+        x = VIEW_WIDTH / 2.0;
+        y = VIEW_HEIGHT / 2.0;
+    }
+
+      // The objects to draw for this world; each world has its own, so
+      // several worlds can exist in one process
+
+    RenderList& renderList()
+    {
+        return m_renderList;
+    }
+
+      // Separate random streams, so that e.g. drawing the status line does
+      // not change what the zombies do.  The same seed replays the same game.
+
+    RandomGenerator& aiRandom()
+    {
+        return m_aiRandom;
+    }
+
+    RandomGenerator& spawnRandom()
+    {
+        return m_spawnRandom;
+    }
+
+    RandomGenerator& cosmeticRandom()
+    {
+        return m_cosmeticRandom;
+    }
+
+    std::uint64_t getSeed() const
+    {
+        return m_seed;
+    }
+
+    void setSeed(std::uint64_t seed)
+    {
+        m_seed = seed;
+        m_aiRandom.setSeed(seed, 1);
+        m_spawnRandom.setSeed(seed, 2);
+        m_cosmeticRandom.setSeed(seed, 3);
+    }
     
       // The following should be used by only the framework, not the student
 
@@ -78,17 +166,28 @@ public:
         ++m_level;
     }
    
-    void setController(GameController* controller)
+    void setController(WorldController* controller)
     {
         m_controller = controller;
     }
+
+    void setRecorder(ReplayRecorder* recorder)
+    {
+        m_recorder = recorder;
+    }
     
 private:
     int m_lives;
     int m_score;
     int m_level;
-    GameController* m_controller;
+    WorldController* m_controller;
+    ReplayRecorder* m_recorder;
     std::string     m_assetPath;
+    RenderList      m_renderList;
+    std::uint64_t   m_seed;
+    RandomGenerator m_aiRandom;
+    RandomGenerator m_spawnRandom;
+    RandomGenerator m_cosmeticRandom;
 };
 
 #endif // GAMEWORLD_H_
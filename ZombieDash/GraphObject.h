@@ -1,16 +1,18 @@
 #ifndef GRAPHOBJ_H_
 #define GRAPHOBJ_H_
 
-#include "SpriteManager.h"
 #include "GameConstants.h"
 
-#include <set>
+#include <vector>
 #include <cmath>
+#include <algorithm>
 
 const int ANIMATION_POSITIONS_PER_TICK = 1;
 
 using Direction = int;
 
+class RenderList;
+
 class GraphObject
 {
   public:
@@ -20,20 +22,12 @@ class GraphObject
     static const int up = 90;
     static const int down = 270;
 
-    GraphObject(int imageID, double startX, double startY, Direction dir = 0, int depth = 0, double size = 1.0)
-     : m_imageID(imageID), m_x(startX), m_y(startY), m_destX(startX), m_destY(startY),
-       m_animationNumber(0), m_direction(dir), m_depth(depth), m_size(size)
-    {
-        if (m_size <= 0)
-            m_size = 1;
+      // If renderList is not null, the object is drawn by that list for as
+      // long as it exists
+    GraphObject(int imageID, double startX, double startY, Direction dir = 0, int depth = 0, double size = 1.0,
+                RenderList* renderList = nullptr);
 
-        getGraphObjects(m_depth).insert(this);
-    }
-
-    virtual ~GraphObject()
-    {
-        getGraphObjects(m_depth).erase(this);
-    }
+    virtual ~GraphObject();
 
     double getX() const
     {
@@ -47,12 +41,7 @@ class GraphObject
         return m_destY;
     }
 
-    virtual void moveTo(double x, double y)
-    {
-        m_destX = x;
-        m_destY = y;
-        increaseAnimationNumber();
-    }
+    virtual void moveTo(double x, double y);
 
     Direction getDirection() const
     {
@@ -84,25 +73,14 @@ class GraphObject
         m_animationNumber++;
     }
 
-    template<typename Func>
-    static void drawAllObjects(Func plotFunc)
-    {
-        for (int depth = NUM_DEPTHS - 1; depth >= 0; depth--)
-        {
-            for (GraphObject* go : getGraphObjects(depth))
-            {
-                go->animate();
-                plotFunc(go->m_imageID, go->m_animationNumber, go->m_x, go->m_y, go->m_direction, go->m_size);
-            }
-        }
-    }
-
       // Prevent copying or assigning GraphObjects
     GraphObject(const GraphObject&) = delete;
     GraphObject& operator=(const GraphObject&) = delete;
 
   private:
 
+    friend class RenderList;
+
     static const int NUM_DEPTHS = 4;
     int     m_imageID;
     double  m_x;
@@ -113,6 +91,9 @@ class GraphObject
     Direction   m_direction;
     int     m_depth;
     double  m_size;
+    RenderList* m_renderList;
+    int     m_renderTile;
+    int     m_renderSlot;
 
     void animate()
     {
@@ -133,14 +114,172 @@ class GraphObject
             from = to;
     }
 
-    static std::set<GraphObject*>& getGraphObjects(int depth)
+};
+
+  // The objects a world draws, bucketed by depth and by the square tile of
+  // the world their position is in, so drawing a view of a large world only
+  // visits the tiles it overlaps.  Each object keeps its tile and its index
+  // in that tile's bucket, so adding, removing, and moving one are O(1).
+  // Within a depth, objects are drawn tile by tile, row by row.
+
+class RenderList
+{
+  public:
+
+    static const int TILE_SIZE = 8 * SPRITE_WIDTH;   // pixels per side of a tile
+
+    RenderList()
+     : m_cols(0), m_rows(0), m_count(0)
     {
-        static std::set<GraphObject*> graphObjects[NUM_DEPTHS];
-        if (depth < NUM_DEPTHS)
-            return graphObjects[depth];
-        else
-            return graphObjects[0];     // empty;
+        setBounds(VIEW_WIDTH, VIEW_HEIGHT);
+    }
+
+      // Sizes the tiles to cover a world of width x height pixels; objects
+      // outside it go in the nearest tile on its edge
+    void setBounds(int width, int height)
+    {
+        std::vector<GraphObject*> objects;
+        for (int depth = 0; depth < GraphObject::NUM_DEPTHS; depth++)
+            for (const std::vector<GraphObject*>& tile : m_tiles[depth])
+                objects.insert(objects.end(), tile.begin(), tile.end());
+
+        m_cols = std::max((width + TILE_SIZE - 1) / TILE_SIZE, 1);
+        m_rows = std::max((height + TILE_SIZE - 1) / TILE_SIZE, 1);
+        for (int depth = 0; depth < GraphObject::NUM_DEPTHS; depth++)
+            m_tiles[depth].assign(m_cols * m_rows, std::vector<GraphObject*>());
+        m_count = 0;
+        for (GraphObject* go : objects)
+            add(go);
+    }
+
+    void add(GraphObject* go)
+    {
+        go->m_renderTile = tileAt(go->m_destX, go->m_destY);
+        std::vector<GraphObject*>& tile = m_tiles[depthIndex(go->m_depth)][go->m_renderTile];
+        go->m_renderSlot = static_cast<int>(tile.size());
+        tile.push_back(go);
+        m_count++;
+    }
+
+    void remove(GraphObject* go)
+    {
+        std::vector<GraphObject*>& tile = m_tiles[depthIndex(go->m_depth)][go->m_renderTile];
+        tile[go->m_renderSlot] = tile.back();
+        tile[go->m_renderSlot]->m_renderSlot = go->m_renderSlot;
+        tile.pop_back();
+        go->m_renderSlot = -1;
+        m_count--;
+    }
+
+      // Moves an object whose destination has changed to the tile it is now in
+    void moved(GraphObject* go)
+    {
+        if (tileAt(go->m_destX, go->m_destY) != go->m_renderTile)
+        {
+            remove(go);
+            add(go);
+        }
+    }
+
+      // The number of objects in the list
+    int size() const
+    {
+        return m_count;
+    }
+
+    template<typename Func>
+    void drawAll(Func plotFunc)
+    {
+        draw(0, 0, m_cols * TILE_SIZE, m_rows * TILE_SIZE, plotFunc);
+    }
+
+      // Draws the objects whose tiles overlap the rectangle from (minX, minY)
+      // to (maxX, maxY), which should allow for objects' sprites reaching
+      // beyond their positions
+    template<typename Func>
+    void draw(double minX, double minY, double maxX, double maxY, Func plotFunc)
+    {
+        draw(minX, minY, maxX, maxY, plotFunc, [](){});
+    }
+
+      // As above, but calls depthDoneFunc after plotting each depth, so a
+      // caller batching its sprites can submit one batch per depth
+    template<typename Func, typename DoneFunc>
+    void draw(double minX, double minY, double maxX, double maxY, Func plotFunc, DoneFunc depthDoneFunc)
+    {
+        int colMin = clampTile(minX, m_cols), colMax = clampTile(maxX, m_cols);
+        int rowMin = clampTile(minY, m_rows), rowMax = clampTile(maxY, m_rows);
+        for (int depth = GraphObject::NUM_DEPTHS - 1; depth >= 0; depth--)
+        {
+            for (int row = rowMin; row <= rowMax; row++)
+            {
+                for (int col = colMin; col <= colMax; col++)
+                {
+                    for (GraphObject* go : m_tiles[depth][row * m_cols + col])
+                    {
+                        go->animate();
+                        plotFunc(go->m_imageID, go->m_animationNumber, go->m_x, go->m_y, go->m_direction, go->m_size);
+                    }
+                }
+            }
+            depthDoneFunc();
+        }
+    }
+
+      // Prevent copying or assigning RenderLists
+    RenderList(const RenderList&) = delete;
+    RenderList& operator=(const RenderList&) = delete;
+
+  private:
+
+    int m_cols;
+    int m_rows;
+    int m_count;
+    std::vector<std::vector<GraphObject*>> m_tiles[GraphObject::NUM_DEPTHS];    // row by row
+
+    static int depthIndex(int depth)
+    {
+        return (depth >= 0  &&  depth < GraphObject::NUM_DEPTHS) ? depth : 0;
+    }
+
+    static int clampTile(double coord, int count)
+    {
+        int t = static_cast<int>(std::floor(coord / TILE_SIZE));
+        return t < 0 ? 0 : (t >= count ? count - 1 : t);
+    }
+
+    int tileAt(double x, double y) const
+    {
+        return clampTile(y, m_rows) * m_cols + clampTile(x, m_cols);
     }
 };
 
+inline GraphObject::GraphObject(int imageID, double startX, double startY, Direction dir, int depth, double size,
+                                RenderList* renderList)
+ : m_imageID(imageID), m_x(startX), m_y(startY), m_destX(startX), m_destY(startY),
+   m_animationNumber(0), m_direction(dir), m_depth(depth), m_size(size),
+   m_renderList(renderList), m_renderTile(0), m_renderSlot(-1)
+{
+    if (m_size <= 0)
+        m_size = 1;
+
+    if (m_renderList != nullptr)
+        m_renderList->add(this);
+}
+
+inline void GraphObject::moveTo(double x, double y)
+{
+    m_destX = x;
+    m_destY = y;
+    increaseAnimationNumber();
+    if (m_renderList != nullptr)
+        m_renderList->moved(this);
+}
+
+inline GraphObject::~GraphObject()
+{
+    if (m_renderList != nullptr)
+        m_renderList->remove(this);
+}
+
 #endif // GRAPHOBJ_H_
@@ -0,0 +1,159 @@
+#include "HeadlessController.h"
+#include "GameConstants.h"
+#include "Replay.h"
+#include <fstream>
+#include <sstream>
+#include <chrono>
+using namespace std;
+
+static bool parseKey(const string& name, int& value)
+{
+    static const map<string, int> names = {
+        { "left" , KEY_PRESS_LEFT  },
+        { "right", KEY_PRESS_RIGHT },
+        { "up"   , KEY_PRESS_UP    },
+        { "down" , KEY_PRESS_DOWN  },
+        { "space", KEY_PRESS_SPACE },
+        { "tab"  , KEY_PRESS_TAB   },
+        { "enter", KEY_PRESS_ENTER },
+    };
+
+    auto it = names.find(name);
+    if (it != names.end())
+    {
+        value = it->second;
+        return true;
+    }
+    if (name.size() == 1)
+    {
+        value = name[0];
+        return true;
+    }
+    return false;
+}
+
+bool KeyScript::load(string filename)
+{
+    ifstream scriptFile(filename);
+    if (!scriptFile)
+        return false;
+
+    string line;
+    while (getline(scriptFile, line))
+    {
+        if (line.empty()  ||  line[0] == '#')
+            continue;
+        istringstream iss(line);
+        long tick;
+        string name;
+        int key;
+        if (!(iss >> tick >> name)  ||  !parseKey(name, key))
+            return false;
+        m_keys[tick] = key;
+    }
+    return true;
+}
+
+bool KeyScript::getKey(long tick, int& value)
+{
+    auto it = m_keys.find(tick);
+    if (it == m_keys.end())
+        return false;
+    value = it->second;
+    return true;
+}
+
+HeadlessController::HeadlessController(GameWorld* gw, KeySource* keys)
+ : m_gw(gw), m_keys(keys), m_recorder(nullptr), m_ticks(0), m_seconds(0),
+   m_started(false), m_done(false), m_stopAtLevelEnd(false), m_status(GWSTATUS_CONTINUE_GAME),
+   m_quit(false), m_keyPending(false), m_pendingKey(0)
+{
+    m_gw->setController(this);
+}
+
+void HeadlessController::setRecorder(ReplayRecorder* recorder)
+{
+    m_recorder = recorder;
+    m_gw->setRecorder(recorder);
+}
+
+int HeadlessController::run(long maxTicks)
+{
+    auto start = chrono::steady_clock::now();
+
+    if (!m_started)
+    {
+        m_started = true;
+        initLevel();
+    }
+    while (!m_done  &&  !m_quit  &&  (maxTicks < 0  ||  m_ticks < maxTicks))
+    {
+          // make this tick's key (if any) available to the next getKey()
+        m_keyPending = m_keys != nullptr  &&  m_keys->getKey(m_ticks, m_pendingKey);
+
+        m_status = m_gw->move();
+        m_ticks++;
+        if (m_recorder != nullptr)
+            m_recorder->tickEnded();
+
+        if (m_status == GWSTATUS_PLAYER_DIED)
+        {
+            m_gw->cleanUp();
+            if (m_gw->isGameOver())
+                m_done = true;
+            else
+                initLevel();
+        }
+        else if (m_status == GWSTATUS_FINISHED_LEVEL)
+        {
+            if (m_stopAtLevelEnd)
+            {
+                m_done = true;
+                break;
+            }
+            m_gw->advanceToNextLevel();
+            m_gw->cleanUp();
+            initLevel();
+        }
+    }
+
+    m_seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return m_status;
+}
+
+void HeadlessController::initLevel()
+{
+    m_status = m_gw->init();
+    if (m_status == GWSTATUS_PLAYER_WON  ||  m_status == GWSTATUS_LEVEL_ERROR)
+    {
+        m_done = true;
+        return;
+    }
+    if (m_recorder != nullptr)
+        m_recorder->levelStarted(m_gw->getLevel());
+    if (m_keys != nullptr)
+        m_keys->levelStarted(m_ticks, m_gw->getLevel());
+}
+
+bool HeadlessController::getLastKey(int& value)
+{
+    if (!m_keyPending)
+        return false;
+    value = m_pendingKey;
+    m_keyPending = false;
+    return true;
+}
+
+void HeadlessController::playSound(int /* soundID */)
+{
+}
+
+void HeadlessController::setGameStatText(string text)
+{
+    m_gameStatText = text;
+}
+
+void HeadlessController::quitGame()
+{
+    m_quit = true;
+}
@@ -0,0 +1,113 @@
+#ifndef HEADLESSCONTROLLER_H_
+#define HEADLESSCONTROLLER_H_
+
+#include "GameWorld.h"
+#include <string>
+#include <map>
+
+class ReplayRecorder;
+
+  // A source of the key (if any) the player hits on each tick
+
+class KeySource
+{
+  public:
+    virtual ~KeySource()
+    {
+    }
+
+    virtual bool getKey(long tick, int& value) = 0;
+
+      // Called whenever a level has been loaded, before its first tick
+    virtual void levelStarted(long /* tick */, int /* level */)
+    {
+    }
+};
+
+  // Keys read from a script with one "<tick> <key>" pair per line, where
+  // key is left, right, up, down, space, tab, enter, or a single character.
+  // Blank lines and lines starting with '#' are ignored.
+
+class KeyScript : public KeySource
+{
+  public:
+    bool load(std::string filename);
+
+    virtual bool getKey(long tick, int& value);
+
+  private:
+    std::map<long, int> m_keys;
+};
+
+  // Drives a GameWorld through init()/move()/cleanUp() in a tight loop,
+  // without a window, a frame timer, or sound
+
+class HeadlessController : public WorldController
+{
+  public:
+    HeadlessController(GameWorld* gw, KeySource* keys = nullptr);
+
+    void setRecorder(ReplayRecorder* recorder);
+
+      // Stop as soon as the current level is finished instead of moving on
+    void setStopAtLevelEnd(bool stop)
+    {
+        m_stopAtLevelEnd = stop;
+    }
+
+      // Runs until tick maxTicks (or forever if negative) or until the game
+      // ends.  Calling run() again continues from where the last call left
+      // off, so run(n) fast-forwards to tick n.  Returns the status of the
+      // last init() or move().
+    int run(long maxTicks);
+
+      // Whether the game has ended (or the level, if stopping at level end)
+    bool done() const
+    {
+        return m_done;
+    }
+
+    long ticks() const
+    {
+        return m_ticks;
+    }
+
+    double seconds() const
+    {
+        return m_seconds;
+    }
+
+    double ticksPerSecond() const
+    {
+        return m_seconds > 0 ? m_ticks / m_seconds : 0;
+    }
+
+    std::string gameStatText() const
+    {
+        return m_gameStatText;
+    }
+
+    virtual bool getLastKey(int& value);
+    virtual void playSound(int soundID);
+    virtual void setGameStatText(std::string text);
+    virtual void quitGame();
+
+  private:
+    GameWorld*  m_gw;
+    KeySource*  m_keys;
+    ReplayRecorder* m_recorder;
+    long        m_ticks;
+    double      m_seconds;
+    bool        m_started;
+    bool        m_done;
+    bool        m_stopAtLevelEnd;
+    int         m_status;
+    bool        m_quit;
+    bool        m_keyPending;
+    int         m_pendingKey;
+    std::string m_gameStatText;
+
+    void initLevel();
+};
+
+#endif // HEADLESSCONTROLLER_H_
@@ -4,14 +4,22 @@
 #include "GameConstants.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <cctype>
 
+  // A level's maze, read from a file with one line per row of cells, top
+  // row first.  An optional first line "width height" gives the size of the
+  // maze in cells, up to MAX_LEVEL_WIDTH x MAX_LEVEL_HEIGHT; without it the
+  // maze is LEVEL_WIDTH x LEVEL_HEIGHT.  The cells are kept one byte each,
+  // row by row, in a single block.
+
 class Level
 {
 public:
 
-    enum MazeEntry {
+    enum MazeEntry : unsigned char {
         empty, player, dumb_zombie, smart_zombie, citizen, wall, exit, pit,
         vaccine_goodie, gas_can_goodie, landmine_goodie
     };
@@ -23,9 +31,7 @@ public:
     Level(std::string assetPath)
      : m_assetPath(assetPath)
     {
-        for (int y = 0; y < LEVEL_HEIGHT; y++)
-            for (int x = 0; x < LEVEL_WIDTH; x++)
-                m_maze[y][x] = empty;
+        resize(LEVEL_WIDTH, LEVEL_HEIGHT);
     }
 
     LoadResult loadLevel(std::string filename)
@@ -34,13 +40,31 @@ public:
         if (!levelFile)
             return load_fail_file_not_found;
 
-          // get the maze
+          // get the size, if the file gives one
 
         std::string line;
+        bool haveLine = static_cast<bool>(std::getline(levelFile, line));
+        std::string::size_type start = haveLine ? line.find_first_not_of(" \t") : std::string::npos;
+        if (start != std::string::npos  &&  isdigit(static_cast<unsigned char>(line[start])))
+        {
+            std::istringstream header(line);
+            int width, height;
+            char extra;
+            if (!(header >> width >> height)  ||  header >> extra  ||
+                width < 3  ||  width > MAX_LEVEL_WIDTH  ||  height < 3  ||  height > MAX_LEVEL_HEIGHT)
+                return load_fail_bad_format;
+            resize(width, height);
+            haveLine = static_cast<bool>(std::getline(levelFile, line));
+        }
+        else
+            resize(LEVEL_WIDTH, LEVEL_HEIGHT);
+
+          // get the maze
+
         bool foundExit = false;
         bool foundPlayer = false;
 
-        for (int y = LEVEL_HEIGHT-1; std::getline(levelFile, line); y--)
+        for (int y = m_height-1; haveLine; y--, haveLine = static_cast<bool>(std::getline(levelFile, line)))
         {
             if (y < 0)    // too many maze lines?
             {
@@ -53,12 +77,13 @@ public:
                 break;
             }
 
-            if (line.size() < LEVEL_WIDTH  ||  line.find_first_not_of(" \t\r", LEVEL_WIDTH) != std::string::npos)
+            if (line.size() < m_width  ||  line.find_first_not_of(" \t\r", m_width) != std::string::npos)
                 return load_fail_bad_format;
                 
-            for (int x = 0; x < LEVEL_WIDTH; x++)
+            MazeEntry* row = &m_maze[y * m_width];
+            for (int x = 0; x < m_width; x++)
             {
-                MazeEntry& me = m_maze[y][x];
+                MazeEntry& me = row[x];
                 switch (toupper(line[x]))
                 {
                     default:   return load_fail_bad_format;
@@ -85,20 +110,40 @@ public:
 
     MazeEntry getContentsOf(int x, int y) const
     {
-        return (x >= 0 && x < LEVEL_WIDTH && y >= 0 && y < LEVEL_HEIGHT) ? m_maze[y][x] : empty;
+        return (x >= 0 && x < m_width && y >= 0 && y < m_height) ? m_maze[y * m_width + x] : empty;
+    }
+
+      // The size of the maze in cells
+    int width() const
+    {
+        return m_width;
+    }
+
+    int height() const
+    {
+        return m_height;
     }
 
 private:
-    MazeEntry   m_maze[LEVEL_HEIGHT][LEVEL_WIDTH];
-    std::string m_assetPath;
+    int                    m_width;
+    int                    m_height;
+    std::vector<MazeEntry> m_maze;    // row by row, bottom row first
+    std::string            m_assetPath;
+
+    void resize(int width, int height)
+    {
+        m_width = width;
+        m_height = height;
+        m_maze.assign(static_cast<size_t>(width) * height, empty);
+    }
 
     bool edgesValid() const
     {
-        for (int y = 0; y < LEVEL_HEIGHT; y++)
-            if (m_maze[y][0] != wall || m_maze[y][LEVEL_WIDTH-1] != wall)
+        for (int y = 0; y < m_height; y++)
+            if (getContentsOf(0, y) != wall || getContentsOf(m_width-1, y) != wall)
                 return false;
-        for (int x = 0; x < LEVEL_WIDTH; x++)
-            if (m_maze[0][x] != wall || m_maze[LEVEL_HEIGHT-1][x] != wall)
+        for (int x = 0; x < m_width; x++)
+            if (getContentsOf(x, 0) != wall || getContentsOf(x, m_height-1) != wall)
                 return false;
 
         return true;
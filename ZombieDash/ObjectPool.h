@@ -0,0 +1,91 @@
+#ifndef OBJECTPOOL_H_
+#define OBJECTPOOL_H_
+
+#include <vector>
+#include <new>
+
+  // Storage for objects of type T that are created and destroyed often.
+  // Slots are carved out of chunks that are kept until the pool itself is
+  // destroyed, so once the pool has grown to the largest number of objects
+  // alive at once, creating and destroying objects never touches the heap.
+  //     T* p = new (pool.allocate()) T(...);
+  //     ...
+  //     pool.release(p);
+
+template<typename T>
+class ObjectPool
+{
+public:
+
+    ObjectPool()
+     : m_inUse(0), m_highWater(0)
+    {
+    }
+
+    ~ObjectPool()
+    {
+        for (size_t k = 0; k < m_chunks.size(); k++)
+            ::operator delete(m_chunks[k]);
+    }
+
+      // Returns uninitialized storage for one T
+    void* allocate()
+    {
+        if (m_free.empty())
+            grow();
+        void* slot = m_free.back();
+        m_free.pop_back();
+        if (++m_inUse > m_highWater)
+            m_highWater = m_inUse;
+        return slot;
+    }
+
+      // Destroys an object created in storage from allocate() and makes its
+      // storage available again
+    void release(T* object)
+    {
+        object->~T();
+        m_free.push_back(object);
+        m_inUse--;
+    }
+
+    int inUse() const
+    {
+        return m_inUse;
+    }
+
+    int highWater() const
+    {
+        return m_highWater;
+    }
+
+    int capacity() const
+    {
+        return static_cast<int>(m_chunks.size()) * CHUNK_SIZE;
+    }
+
+      // Prevent copying or assigning ObjectPools
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+private:
+
+    static const int CHUNK_SIZE = 64;
+
+    std::vector<void*> m_chunks;
+    std::vector<void*> m_free;
+    int m_inUse;
+    int m_highWater;
+
+    void grow()
+    {
+        char* chunk = static_cast<char*>(::operator new(sizeof(T) * CHUNK_SIZE));
+        m_chunks.push_back(chunk);
+        m_free.reserve(capacity());
+          // Hand out the lowest addresses first
+        for (int k = CHUNK_SIZE - 1; k >= 0; k--)
+            m_free.push_back(chunk + k * sizeof(T));
+    }
+};
+
+#endif // OBJECTPOOL_H_
@@ -0,0 +1,123 @@
+#include "Profiler.h"
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <cstdlib>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+using namespace std;
+
+namespace {
+    // Phase names are shared by all threads, so a phase has the same number everywhere
+    mutex registryMutex;
+    vector<string> phaseNames;
+
+    // Returns the readable name of a class
+    string className(const type_info& type) {
+#ifdef __GNUG__
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(type.name(), NULL, NULL, &status);
+        if (status == 0 && demangled != NULL) {
+            string result(demangled);
+            free(demangled);
+            return result;
+        }
+#endif
+        string name(type.name());
+        return name.compare(0, 6, "class ") == 0 ? name.substr(6) : name;
+    }
+}
+
+// Histogram
+void Profiler::Histogram::record(uint64_t ns) {
+    m_buckets[bucket(ns)]++;
+    m_count++;
+    m_total += ns;
+    if (ns > m_max) m_max = ns;
+}
+
+uint64_t Profiler::Histogram::percentile(double p) const {
+    if (m_count == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(p * m_count + 0.5), seen = 0;
+    if (target == 0) target = 1;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += m_buckets[b];
+        if (seen >= target) return min(upperBound(b), m_max);
+    }
+    return m_max;
+}
+
+int Profiler::Histogram::bucket(uint64_t ns) {
+    if (ns < (uint64_t(1) << SUB_BITS)) return static_cast<int>(ns);
+    int lead = 63;
+    while (!(ns >> lead)) lead--;
+    int sub = static_cast<int>(ns >> (lead - SUB_BITS)) & ((1 << SUB_BITS) - 1);
+    return ((lead - SUB_BITS + 1) << SUB_BITS) + sub;
+}
+
+uint64_t Profiler::Histogram::upperBound(int bucket) {
+    if (bucket < (1 << SUB_BITS)) return bucket;
+    int lead = (bucket >> SUB_BITS) + SUB_BITS - 1;
+    uint64_t sub = bucket & ((1 << SUB_BITS) - 1);
+    uint64_t width = uint64_t(1) << (lead - SUB_BITS);
+    return (((uint64_t(1) << SUB_BITS) + sub) << (lead - SUB_BITS)) + width - 1;
+}
+
+// Accessors
+Profiler& Profiler::get() {
+    static thread_local Profiler profiler;
+    return profiler;
+}
+
+int Profiler::phase(const string& name) {
+    lock_guard<mutex> lock(registryMutex);
+    for (int i = 0; i < phaseNames.size(); i++)
+        if (phaseNames[i] == name) return i;
+    phaseNames.push_back(name);
+    return phaseNames.size() - 1;
+}
+
+int Profiler::phase(const type_info& type) {
+    unordered_map<type_index, int>::const_iterator it = m_classes.find(type_index(type));
+    if (it != m_classes.end()) return it->second;
+    int number = phase(className(type) + "::doSomething");
+    m_classes[type_index(type)] = number;
+    return number;
+}
+
+void Profiler::report(ostream& out) const {
+    vector<string> names;
+    {
+        lock_guard<mutex> lock(registryMutex);
+        names = phaseNames;
+    }
+    ios_base::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    // Columns are separated by spaces of their own, so that even values too wide for a column (a latency in seconds, say)
+    // stay apart from their neighbours
+    const char* SEP = "  ";
+    out << left << setw(28) << "phase" << right << SEP << setw(10) << "count" << SEP << setw(12) << "total ms"
+        << SEP << setw(12) << "mean us" << SEP << setw(12) << "p50 us" << SEP << setw(12) << "p99 us" << SEP << setw(12) << "max us" << endl;
+    out << fixed << setprecision(2);
+    for (int i = 0; i < m_phases.size(); i++) {
+        const Histogram& h = m_phases[i];
+        if (h.count() == 0) continue;
+        out << left << setw(28) << names[i] << right << SEP << setw(10) << h.count() << SEP << setw(12) << h.total() / 1e6
+            << SEP << setw(12) << h.total() / 1e3 / h.count() << SEP << setw(12) << h.percentile(0.5) / 1e3
+            << SEP << setw(12) << h.percentile(0.99) / 1e3 << SEP << setw(12) << h.max() / 1e3 << endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+// Mutators
+void Profiler::record(int phase, uint64_t ns) {
+    if (phase >= m_phases.size()) m_phases.resize(phase + 1);
+    m_phases[phase].record(ns);
+}
+
+void Profiler::reset() {
+    for (int i = 0; i < m_phases.size(); i++)
+        m_phases[i] = Histogram();
+}
@@ -0,0 +1,86 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <typeinfo>
+#include <typeindex>
+#include <unordered_map>
+
+/* Profiler Class Declaration
+ * - Latency histograms of the phases of a tick (Penelope's turn, each actor class's turns, removing the dead, the status text, drawing, and the buffer swap)
+ * - Only compiled in when ZOMBIEDASH_PROFILE is defined (e.g. -DZOMBIEDASH_PROFILE); otherwise the PROFILE_ macros below expand to nothing and cost nothing
+ * - Each histogram has 8 buckets per power of two of nanoseconds, so percentiles are within 1/8 of the true value, with exact counts, totals, and maxima
+ * - Samples are kept per thread, since each game runs on one thread; the report shows the samples of the thread that asks for it
+ */
+class Profiler {
+public:
+    // Latencies of one phase
+    class Histogram {
+    public:
+        Histogram() : m_buckets(BUCKETS, 0), m_count(0), m_total(0), m_max(0) {}
+        void record(std::uint64_t ns);  // Adds a sample of ns nanoseconds
+        std::uint64_t count() const {return m_count;} // Returns the number of samples
+        std::uint64_t total() const {return m_total;} // Returns the sum of the samples in nanoseconds
+        std::uint64_t max() const {return m_max;}     // Returns the largest sample in nanoseconds
+        std::uint64_t percentile(double p) const;     // Returns the smallest bucket bound that at least fraction p of the samples fall under
+    private:
+        static const int SUB_BITS = 3;                   // Number of bits of each sample kept below its leading bit
+        static const int BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+        std::vector<std::uint64_t> m_buckets;            // Number of samples in each bucket
+        std::uint64_t m_count;
+        std::uint64_t m_total;
+        std::uint64_t m_max;
+        static int bucket(std::uint64_t ns);             // Returns the bucket ns falls in
+        static std::uint64_t upperBound(int bucket);     // Returns the largest sample that falls in bucket
+    };
+
+    // Accessors
+    static Profiler& get();                        // Returns the calling thread's profiler
+    static int phase(const std::string& name);     // Returns the number of the phase with the given name, registering it if it is new
+    int phase(const std::type_info& type);         // Returns the number of the phase named after the class type
+    void report(std::ostream& out) const;          // Writes a table of every phase's samples to out
+
+    // Mutators
+    void record(int phase, std::uint64_t ns);      // Adds a sample of ns nanoseconds to phase
+    void reset();                                  // Forgets all samples
+private:
+    Profiler() {}
+    std::vector<Histogram> m_phases;                    // Histogram of each phase this thread has recorded, by number
+    std::unordered_map<std::type_index, int> m_classes; // Phase numbers of the actor classes seen so far
+};
+
+/* ProfileScope Class Declaration
+ * - Times its own lifetime and records it as a sample of a phase
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(int phase) : m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+    ~ProfileScope() {Profiler::get().record(m_phase, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());}
+private:
+    int m_phase;
+    std::chrono::steady_clock::time_point m_start;
+    ProfileScope(const ProfileScope&);
+    ProfileScope& operator=(const ProfileScope&);
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+
+#ifdef ZOMBIEDASH_PROFILE
+// Times the rest of the enclosing block as the named phase
+#define PROFILE_PHASE(name) static const int PROFILE_CONCAT(profilePhase, __LINE__) = Profiler::phase(name); ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profilePhase, __LINE__))
+// Times the rest of the enclosing block as a phase named after the class of *object
+#define PROFILE_CLASS(object) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(Profiler::get().phase(typeid(object)))
+// Writes the calling thread's table to out
+#define PROFILE_REPORT(out) Profiler::get().report(out)
+#else
+#define PROFILE_PHASE(name)
+#define PROFILE_CLASS(object)
+#define PROFILE_REPORT(out)
+#endif
+
+#endif // PROFILER_H_
@@ -0,0 +1,92 @@
+#ifndef RANDOMGENERATOR_H_
+#define RANDOMGENERATOR_H_
+
+#include <cstdint>
+
+  // A small, fast, seedable PCG32 generator.  Generators built from the
+  // same seed but different stream numbers produce independent sequences.
+
+class RandomGenerator
+{
+public:
+
+    RandomGenerator(std::uint64_t seed = 0, std::uint64_t stream = 0)
+    {
+        setSeed(seed, stream);
+    }
+
+    void setSeed(std::uint64_t seed, std::uint64_t stream)
+    {
+        m_state = 0;
+        m_inc = (stream << 1) | 1;
+        next();
+        m_state += seed;
+        next();
+    }
+
+    std::uint32_t next()
+    {
+        std::uint64_t old = m_state;
+        m_state = old * 6364136223846793005ULL + m_inc;
+        std::uint32_t xorshifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        std::uint32_t rot = static_cast<std::uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+      // Return a uniformly distributed random int from min to max, inclusive
+
+    int randInt(int min, int max)
+    {
+        if (max < min)
+        {
+            int t = min;
+            min = max;
+            max = t;
+        }
+        std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+        return static_cast<int>(static_cast<std::uint32_t>(min) + bounded(range));
+    }
+
+      // Fill out[0..count-1] with uniformly distributed random ints from min
+      // to max, inclusive, setting up the range only once
+
+    void randInts(int min, int max, int* out, int count)
+    {
+        if (max < min)
+        {
+            int t = min;
+            min = max;
+            max = t;
+        }
+        std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+        for (int k = 0; k < count; k++)
+            out[k] = static_cast<int>(static_cast<std::uint32_t>(min) + bounded(range));
+    }
+
+private:
+
+    std::uint64_t m_state;
+    std::uint64_t m_inc;
+
+      // Lemire's multiply-and-shift method: unbiased, and almost never divides
+
+    std::uint32_t bounded(std::uint32_t range)
+    {
+        if (range == 0)     // the full 32-bit range
+            return next();
+        std::uint64_t m = static_cast<std::uint64_t>(next()) * range;
+        std::uint32_t low = static_cast<std::uint32_t>(m);
+        if (low < range)
+        {
+            std::uint32_t threshold = (0u - range) % range;
+            while (low < threshold)
+            {
+                m = static_cast<std::uint64_t>(next()) * range;
+                low = static_cast<std::uint32_t>(m);
+            }
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+};
+
+#endif // RANDOMGENERATOR_H_
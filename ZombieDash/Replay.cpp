@@ -0,0 +1,195 @@
+#include "Replay.h"
+#include "GameConstants.h"
+#include <algorithm>
+using namespace std;
+
+static const char REPLAY_MAGIC[4] = { 'Z', 'D', 'R', 'P' };
+static const char REPLAY_VERSION = 1;
+
+static const int CODE_ARROW_BASE = 0x80;
+static const int CODE_OTHER_KEY  = 0xFC;
+static const int CODE_IDLE       = 0xFD;
+static const int CODE_LEVEL      = 0xFE;
+static const int CODE_END        = 0xFF;
+
+ReplayRecorder::ReplayRecorder()
+ : m_idleTicks(0), m_keyThisTick(false), m_key(0)
+{
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+    close();
+}
+
+bool ReplayRecorder::open(string filename, uint64_t seed)
+{
+    m_file.open(filename, ios::out | ios::binary | ios::trunc);
+    if (!m_file)
+        return false;
+    m_file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    m_file.put(REPLAY_VERSION);
+    for (int k = 0; k < 8; k++)
+        m_file.put(static_cast<char>(seed >> (8 * k)));
+    m_idleTicks = 0;
+    m_keyThisTick = false;
+    return true;
+}
+
+void ReplayRecorder::close()
+{
+    if (!m_file.is_open())
+        return;
+    flushIdleTicks();
+    m_file.put(static_cast<char>(CODE_END));
+    m_file.close();
+}
+
+void ReplayRecorder::levelStarted(int level)
+{
+    if (!m_file.is_open())
+        return;
+    flushIdleTicks();
+    m_file.put(static_cast<char>(CODE_LEVEL));
+    writeVarint(level);
+}
+
+void ReplayRecorder::keyReturned(int key)
+{
+    m_keyThisTick = true;
+    m_key = key;
+}
+
+void ReplayRecorder::tickEnded()
+{
+    if (!m_file.is_open())
+        return;
+    if (!m_keyThisTick)
+    {
+        m_idleTicks++;
+        return;
+    }
+    m_keyThisTick = false;
+    flushIdleTicks();
+    if (m_key > 0  &&  m_key < 0x80)
+        m_file.put(static_cast<char>(m_key));
+    else if (m_key >= KEY_PRESS_LEFT  &&  m_key <= KEY_PRESS_DOWN)
+        m_file.put(static_cast<char>(CODE_ARROW_BASE + m_key - KEY_PRESS_LEFT));
+    else
+    {
+        m_file.put(static_cast<char>(CODE_OTHER_KEY));
+        m_file.put(static_cast<char>(m_key));
+    }
+}
+
+void ReplayRecorder::flushIdleTicks()
+{
+    if (m_idleTicks == 0)
+        return;
+    m_file.put(static_cast<char>(CODE_IDLE));
+    writeVarint(m_idleTicks);
+    m_idleTicks = 0;
+}
+
+void ReplayRecorder::writeVarint(uint64_t n)
+{
+    while (n >= 0x80)
+    {
+        m_file.put(static_cast<char>((n & 0x7F) | 0x80));
+        n >>= 7;
+    }
+    m_file.put(static_cast<char>(n));
+}
+
+static bool readVarint(istream& in, uint64_t& n)
+{
+    n = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        int c = in.get();
+        if (c == EOF)
+            return false;
+        n |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if ((c & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+ReplayPlayer::ReplayPlayer()
+ : m_seed(0), m_nextLevel(0), m_desynced(false)
+{
+}
+
+bool ReplayPlayer::load(string filename)
+{
+    ifstream replayFile(filename, ios::in | ios::binary);
+    if (!replayFile)
+        return false;
+
+    char magic[sizeof(REPLAY_MAGIC)];
+    replayFile.read(magic, sizeof(magic));
+    if (!replayFile  ||  !equal(magic, magic + sizeof(magic), REPLAY_MAGIC)  ||  replayFile.get() != REPLAY_VERSION)
+        return false;
+    m_seed = 0;
+    for (int k = 0; k < 8; k++)
+    {
+        int c = replayFile.get();
+        if (c == EOF)
+            return false;
+        m_seed |= static_cast<uint64_t>(c) << (8 * k);
+    }
+
+    m_keys.clear();
+    m_levels.clear();
+    m_nextLevel = 0;
+    m_desynced = false;
+    for (;;)
+    {
+        int c = replayFile.get();
+        uint64_t n;
+        if (c == EOF  ||  c == CODE_END)
+            break;
+        else if (c == CODE_IDLE)
+        {
+            if (!readVarint(replayFile, n))
+                return false;
+            m_keys.insert(m_keys.end(), n, 0);
+        }
+        else if (c == CODE_LEVEL)
+        {
+            if (!readVarint(replayFile, n))
+                return false;
+            m_levels.push_back(make_pair(ticks(), static_cast<int>(n)));
+        }
+        else if (c == CODE_OTHER_KEY)
+        {
+            int key = replayFile.get();
+            if (key == EOF)
+                return false;
+            m_keys.push_back(key);
+        }
+        else if (c >= CODE_ARROW_BASE  &&  c <= CODE_ARROW_BASE + KEY_PRESS_DOWN - KEY_PRESS_LEFT)
+            m_keys.push_back(KEY_PRESS_LEFT + c - CODE_ARROW_BASE);
+        else if (c > 0  &&  c < 0x80)
+            m_keys.push_back(c);
+        else
+            return false;
+    }
+    return true;
+}
+
+bool ReplayPlayer::getKey(long tick, int& value)
+{
+    if (tick < 0  ||  tick >= ticks()  ||  m_keys[tick] == 0)
+        return false;
+    value = m_keys[tick];
+    return true;
+}
+
+void ReplayPlayer::levelStarted(long tick, int level)
+{
+    if (m_nextLevel >= m_levels.size()  ||  m_levels[m_nextLevel] != make_pair(tick, level))
+        m_desynced = true;
+    m_nextLevel++;
+}
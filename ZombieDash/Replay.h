@@ -0,0 +1,82 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "HeadlessController.h"
+#include <string>
+#include <fstream>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+  // Replay files record everything needed to replay a session: the world's
+  // seed, the number of each level as it starts, and the key (if any) that
+  // GameWorld::getKey returned on each tick.  After a small header
+  // ("ZDRP", a version byte, and the seed as 8 little-endian bytes), the
+  // file is a stream of one-byte codes:
+  //     0x01-0x7F      that ASCII key was returned this tick
+  //     0x80-0x83      KEY_PRESS_LEFT/RIGHT/UP/DOWN was returned this tick
+  //     0xFC b         the key b (0x80-0xFF) was returned this tick
+  //     0xFD n         no key was returned for the next n ticks
+  //     0xFE n         level n started
+  //     0xFF           end of the recording
+  // where n is an unsigned LEB128 varint.
+
+class ReplayRecorder
+{
+  public:
+    ReplayRecorder();
+    ~ReplayRecorder();
+
+    bool open(std::string filename, std::uint64_t seed);
+    void close();
+
+    void levelStarted(int level);
+    void keyReturned(int key);
+    void tickEnded();
+
+  private:
+    std::ofstream m_file;
+    long          m_idleTicks;
+    bool          m_keyThisTick;
+    int           m_key;
+
+    void flushIdleTicks();
+    void writeVarint(std::uint64_t n);
+};
+
+class ReplayPlayer : public KeySource
+{
+  public:
+    ReplayPlayer();
+
+    bool load(std::string filename);
+
+    std::uint64_t seed() const
+    {
+        return m_seed;
+    }
+
+    long ticks() const
+    {
+        return static_cast<long>(m_keys.size());
+    }
+
+      // Whether a level started at a different tick, or a different level
+      // started, than in the recording
+    bool desynced() const
+    {
+        return m_desynced;
+    }
+
+    virtual bool getKey(long tick, int& value);
+    virtual void levelStarted(long tick, int level);
+
+  private:
+    std::uint64_t                    m_seed;
+    std::vector<int>                 m_keys;     // key for each tick, or 0 for none
+    std::vector<std::pair<long,int>> m_levels;   // (tick, level) of each level start
+    std::size_t                      m_nextLevel;
+    bool                             m_desynced;
+};
+
+#endif // REPLAY_H_
@@ -0,0 +1,67 @@
+#include "SpatialGrid.h"
+#include "Actor.h"
+#include <cmath>
+using namespace std;
+
+// Constructor
+SpatialGrid::SpatialGrid(int width, int height) : m_cols(max((width + SPRITE_WIDTH - 1) / SPRITE_WIDTH, 1)), m_rows(max((height + SPRITE_HEIGHT - 1) / SPRITE_HEIGHT, 1)), m_cells(m_cols * m_rows), m_cellProperties(m_cols * m_rows, 0) {}
+
+// Mutators
+void SpatialGrid::insert(Actor* actor) {
+    int cell = cellIndex(actor->getX(), actor->getY());
+    m_cells[cell].push_back(actor);
+    m_cellProperties[cell] |= actor->properties();
+}
+
+void SpatialGrid::remove(Actor* actor) {removeFromCell(cellIndex(actor->getX(), actor->getY()), actor);}
+
+void SpatialGrid::move(Actor* actor, double oldX, double oldY) {
+    int from = cellIndex(oldX, oldY);
+    int to = cellIndex(actor->getX(), actor->getY());
+    if (from == to) return;
+    if (!removeFromCell(from, actor)) return;
+    m_cells[to].push_back(actor);
+    m_cellProperties[to] |= actor->properties();
+}
+
+void SpatialGrid::clear() {
+    for (int i = 0; i < m_cells.size(); i++) {
+        m_cells[i].clear();
+        m_cellProperties[i] = 0;
+    }
+}
+
+// Accessors
+int SpatialGrid::maxRing(double x, double y) const {
+    int c = col(x);
+    int r = row(y);
+    return max(max(c, m_cols - 1 - c), max(r, m_rows - 1 - r));
+}
+
+// Helper Functions
+int SpatialGrid::col(double x) const {
+    int c = static_cast<int>(floor(x / SPRITE_WIDTH));
+    return c < 0 ? 0 : (c >= m_cols ? m_cols - 1 : c);
+}
+
+int SpatialGrid::row(double y) const {
+    int r = static_cast<int>(floor(y / SPRITE_HEIGHT));
+    return r < 0 ? 0 : (r >= m_rows ? m_rows - 1 : r);
+}
+
+int SpatialGrid::cellIndex(double x, double y) const {return row(y)*m_cols + col(x);}
+
+bool SpatialGrid::removeFromCell(int cell, Actor* actor) {
+    vector<Actor*>& actors = m_cells[cell];
+    vector<Actor*>::iterator it = find(actors.begin(), actors.end(), actor);
+    if (it == actors.end()) return false;
+    // Order within a cell does not matter, so swap with the last element instead of shifting
+    *it = actors.back();
+    actors.pop_back();
+    // Cells hold only a few actors, so rebuilding the flags is cheap
+    int properties = 0;
+    for (int i = 0; i < actors.size(); i++)
+        properties |= actors[i]->properties();
+    m_cellProperties[cell] = properties;
+    return true;
+}
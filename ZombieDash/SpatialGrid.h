@@ -0,0 +1,98 @@
+#ifndef SPATIALGRID_H_
+#define SPATIALGRID_H_
+
+#include "GameConstants.h"
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+class Actor;
+
+/* SpatialGrid Class Declaration
+ * - Uniform grid of buckets, one per SPRITE_WIDTH x SPRITE_HEIGHT cell, each holding the actors whose position lies in it
+ * - Two actors that overlap or whose bounding boxes intersect always lie in the same or in adjacent cells
+ * - Positions outside of the grid are clamped to the nearest edge cell
+ * - Each cell also keeps the union of its actors' property flags, so queries for a property skip cells that cannot match
+ */
+class SpatialGrid {
+public:
+    // Constructor
+    SpatialGrid(int width, int height); // Creates an empty grid covering width x height pixels
+
+    // Mutators
+    void insert(Actor* actor);                          // Adds actor to the cell containing its position
+    void remove(Actor* actor);                          // Removes actor from the cell containing its position
+    void move(Actor* actor, double oldX, double oldY);  // Moves actor from the cell containing (oldX, oldY) to the one containing its position
+    void clear();                                       // Removes all actors from the grid
+
+    // Accessors
+    int maxRing(double x, double y) const; // Returns the number of rings around (x, y) needed to cover the entire grid
+    // The queries below only visit cells holding some actor with every property in mask (0 visits all cells)
+    template<typename Func>
+    void forEachNear(double x, double y, int radius, int mask, Func func) const;   // Calls func on each actor at most radius cells away from (x, y)
+    template<typename Func>
+    void forEachInRing(double x, double y, int ring, int mask, Func func) const;   // Calls func on each actor exactly ring cells away from (x, y)
+    template<typename Pred>
+    Actor* findNear(double x, double y, int radius, int mask, Pred pred) const;    // Returns the first actor at most radius cells away from (x, y) satisfying pred, or NULL
+private:
+    int m_cols; // Number of columns of cells
+    int m_rows; // Number of rows of cells
+    std::vector<std::vector<Actor*>> m_cells; // Buckets of actors, stored row by row
+    std::vector<int> m_cellProperties; // Union of the property flags of the actors in each bucket
+
+    // Helper Functions
+    int col(double x) const; // Returns the column of the cell containing x, clamped to the grid
+    int row(double y) const; // Returns the row of the cell containing y, clamped to the grid
+    int cellIndex(double x, double y) const; // Returns the index of the bucket containing (x, y)
+    bool removeFromCell(int cell, Actor* actor); // Removes actor from the given bucket and recomputes its property flags, returns whether it was there
+    bool cellHas(int cell, int mask) const {return (m_cellProperties[cell] & mask) == mask;} // Returns whether the bucket may hold an actor with every property in mask
+};
+
+template<typename Func>
+void SpatialGrid::forEachNear(double x, double y, int radius, int mask, Func func) const {
+    int c = col(x);
+    int r = row(y);
+    int cMin = std::max(c - radius, 0), cMax = std::min(c + radius, m_cols - 1);
+    int rMin = std::max(r - radius, 0), rMax = std::min(r + radius, m_rows - 1);
+    for (int j = rMin; j <= rMax; j++)
+        for (int i = cMin; i <= cMax; i++)
+            if (cellHas(j*m_cols + i, mask))
+                for (Actor* actor : m_cells[j*m_cols + i])
+                    func(actor);
+}
+
+template<typename Func>
+void SpatialGrid::forEachInRing(double x, double y, int ring, int mask, Func func) const {
+    if (ring == 0) {
+        forEachNear(x, y, 0, mask, func);
+        return;
+    }
+    int c = col(x);
+    int r = row(y);
+    for (int j = r - ring; j <= r + ring; j++) {
+        if (j < 0 || j >= m_rows) continue;
+        // Rows at the top and bottom of the ring are visited in full, all others only at their two ends
+        int step = (j == r - ring || j == r + ring) ? 1 : 2*ring;
+        for (int i = c - ring; i <= c + ring; i += step) {
+            if (i < 0 || i >= m_cols || !cellHas(j*m_cols + i, mask)) continue;
+            for (Actor* actor : m_cells[j*m_cols + i])
+                func(actor);
+        }
+    }
+}
+
+template<typename Pred>
+Actor* SpatialGrid::findNear(double x, double y, int radius, int mask, Pred pred) const {
+    int c = col(x);
+    int r = row(y);
+    int cMin = std::max(c - radius, 0), cMax = std::min(c + radius, m_cols - 1);
+    int rMin = std::max(r - radius, 0), rMax = std::min(r + radius, m_rows - 1);
+    for (int j = rMin; j <= rMax; j++)
+        for (int i = cMin; i <= cMax; i++)
+            if (cellHas(j*m_cols + i, mask))
+                for (Actor* actor : m_cells[j*m_cols + i])
+                    if (pred(actor)) return actor;
+    return NULL;
+}
+
+#endif // SPATIALGRID_H_
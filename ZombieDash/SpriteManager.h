@@ -11,12 +11,23 @@
 #define GL_BGRA GL_BGRA_EXT
 #endif
 
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+
 #include "GameConstants.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <cmath>
 
 static const double VISIBLE_MIN_X = -2.39;
@@ -26,13 +37,24 @@ static const double VISIBLE_MAX_Y = 1.9;
 static const double VISIBLE_MIN_Z = -20;
 // static const double VISIBLE_MAX_Z = -6;
 
+  // Sprites are loaded into memory one frame at a time, then packed together
+  // into a single atlas texture by buildAtlas().  Each frame, sprites are
+  // added to a batch of quads that drawBatch() submits in one draw call, so
+  // drawing costs one texture bind and one glDrawArrays per batch rather than
+  // a matrix push, attribute push, bind, and glBegin/glEnd per sprite.  Only
+  // OpenGL 1.1 vertex arrays are used, so this works on software renderers.
+
 class SpriteManager
 {
 public:
 
     SpriteManager()
-     : m_mipMapped(true)
+     : m_mipMapped(true), m_atlasTexture(0), m_atlasWidth(0), m_atlasHeight(0)
     {
+          // Precompute the corners of a sprite of size 1 facing each of the
+          // four directions
+        for (int d = 0; d < 4; d++)
+            computeCorners(d * 90, 1, m_corners[d]);
     }
 
     bool loadSprite(std::string filename_tga, int imageID, int frameNum)
@@ -74,53 +96,144 @@ public:
         if (byteCount != 3 && byteCount != 4)
             return false;
 
+        if (textureWidth == 0 || textureHeight == 0)
+            return false;
+
+          // Keep the pixels as BGRA until the atlas is built.  byteCount of 3
+          // means that BGR data is being supplied, which is made opaque.
+        Sprite& sprite = m_sprites[spriteID];
+        sprite.width = textureWidth;
+        sprite.height = textureHeight;
+        sprite.pixels.resize(textureWidth * textureHeight * 4);
+        for (unsigned int i = 0; i < textureWidth * textureHeight; i++)
+        {
+            for (int c = 0; c < 3; c++)
+                sprite.pixels[4*i + c] = static_cast<unsigned char>(imageData[byteCount*i + c]);
+            sprite.pixels[4*i + 3] = (byteCount == 4 ? static_cast<unsigned char>(imageData[4*i + 3]) : 255);
+        }
+
+        return true;
+    }
+
+      // Packs every sprite loaded so far into one texture, replacing any
+      // atlas built before.  Must be called after loading sprites and
+      // before drawing them.  Returns false if they don't fit in the largest
+      // texture the OpenGL implementation supports.
+    bool buildAtlas()
+    {
+          // Place sprites on shelves, tallest first, in the narrowest square
+          // or wider power-of-two texture they fit in.  Each is surrounded
+          // by a gutter of copies of its edge pixels, and starts on a
+          // multiple of the gutter, so filtering, even from the smaller
+          // mipmaps, never blends in a neighboring sprite.
+        std::vector<std::map<int, Sprite>::iterator> order;
+        for (auto it = m_sprites.begin(); it != m_sprites.end(); it++)
+            order.push_back(it);
+        std::stable_sort(order.begin(), order.end(),
+            [](std::map<int, Sprite>::iterator a, std::map<int, Sprite>::iterator b)
+            {
+                return a->second.height > b->second.height;
+            });
+
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        int atlasWidth = 0, atlasHeight = 0;
+        for (int width = 64; width <= maxSize && atlasWidth == 0; width *= 2)
+        {
+            int x = 0, y = 0, shelfHeight = 0;
+            bool fits = true;
+            for (auto it : order)
+            {
+                int w = paddedSize(it->second.width);
+                int h = paddedSize(it->second.height);
+                if (w > width)
+                {
+                    fits = false;
+                    break;
+                }
+                if (x + w > width)
+                {
+                    y += shelfHeight;
+                    x = 0;
+                    shelfHeight = 0;
+                }
+                it->second.x = x + ATLAS_PADDING;
+                it->second.y = y + ATLAS_PADDING;
+                x += w;
+                shelfHeight = std::max(shelfHeight, h);
+            }
+            int height = 64;
+            while (height < y + shelfHeight)
+                height *= 2;
+            if (fits && height <= width)
+            {
+                atlasWidth = width;
+                atlasHeight = height;
+            }
+        }
+        if (atlasWidth == 0)
+            return false;
+
+          // Copy each sprite and its gutter into the atlas
+        std::vector<unsigned char> atlas(atlasWidth * atlasHeight * 4, 0);
+        for (auto it : order)
+        {
+            const Sprite& sprite = it->second;
+            for (int r = -ATLAS_PADDING; r < sprite.height + ATLAS_PADDING; r++)
+            {
+                int sr = std::min(std::max(r, 0), sprite.height - 1);
+                for (int c = -ATLAS_PADDING; c < sprite.width + ATLAS_PADDING; c++)
+                {
+                    int sc = std::min(std::max(c, 0), sprite.width - 1);
+                    std::copy(&sprite.pixels[4 * (sr * sprite.width + sc)], &sprite.pixels[4 * (sr * sprite.width + sc)] + 4,
+                              &atlas[4 * ((sprite.y + r) * atlasWidth + sprite.x + c)]);
+                }
+            }
+        }
+
           // Transfer Texture To OpenGL
 
         glEnable(GL_DEPTH_TEST);
 
-          // allocate a texture handle
-        GLuint glTextureID;
-        glGenTextures(1, &glTextureID);
-
-          // bind our new texture
-        glBindTexture(GL_TEXTURE_2D, glTextureID);
+          // allocate a texture handle the first time, and bind it
+        if (m_atlasTexture == 0)
+            glGenTextures(1, &m_atlasTexture);
+        glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
 
         glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 
         if (m_mipMapped)
         {
-              // when texture area is small, bilinear filter the closest mipmap
+              // when texture area is small, bilinear filter the closest
+              // mipmap, but no smaller than the gutters allow
             glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-              // when texture area is large, bilinear filter the first mipmap
-            glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, ATLAS_MIPMAP_LEVELS);
         }
         else
-        {
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        }
+          // when texture area is large, bilinear filter the first mipmap
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-          // Have the texture wrap both vertically and horizontally.
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLfloat>(GL_REPEAT));
-        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLfloat>(GL_REPEAT));
+          // Sprites must not wrap onto each other
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLfloat>(GL_CLAMP_TO_EDGE));
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLfloat>(GL_CLAMP_TO_EDGE));
 
         if (m_mipMapped)
-        {
-              // build our texture mipmaps
-              // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-            makeMipmaps(byteCount, textureWidth, textureHeight, imageData.get());
-        }
+            makeMipmaps(4, atlasWidth, atlasHeight, reinterpret_cast<char*>(atlas.data()));
         else
+            glTexImage2D(GL_TEXTURE_2D, 0, 4, atlasWidth, atlasHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, atlas.data());
+
+        m_atlasWidth = atlasWidth;
+        m_atlasHeight = atlasHeight;
+        for (auto& entry : m_sprites)
         {
-              // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-            if (3 == byteCount)
-                glTexImage2D(GL_TEXTURE_2D, 0, 3, textureWidth, textureHeight, 0, GL_BGR, GL_UNSIGNED_BYTE, imageData.get());
-            else if (4 == byteCount)
-                glTexImage2D(GL_TEXTURE_2D, 0, 4, textureWidth, textureHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, imageData.get());
+            Sprite& sprite = entry.second;
+            sprite.u0 = static_cast<GLfloat>(sprite.x) / atlasWidth;
+            sprite.v0 = static_cast<GLfloat>(sprite.y) / atlasHeight;
+            sprite.u1 = static_cast<GLfloat>(sprite.x + sprite.width) / atlasWidth;
+            sprite.v1 = static_cast<GLfloat>(sprite.y + sprite.height) / atlasHeight;
         }
 
-        m_imageMap[spriteID] = glTextureID;
-
         return true;
     }
 
@@ -133,91 +246,127 @@ public:
         return it->second;
     }
 
-    bool plotSprite(int imageID, int frame, double x, double y, int angleDegrees, double size)
+      // Adds a sprite to the batch drawn by the next drawBatch()
+    bool addSprite(int imageID, int frame, double x, double y, int angleDegrees, double size)
     {
         int spriteID = getSpriteID(imageID, frame);
-        if (spriteID == INVALID_SPRITE_ID)
+        if (spriteID == INVALID_SPRITE_ID || m_atlasWidth == 0)
             return false;
 
-        auto it = m_imageMap.find(spriteID);
-        if (it == m_imageMap.end())
+        auto it = m_sprites.find(spriteID);
+        if (it == m_sprites.end())
             return false;
+        const Sprite& sprite = it->second;
 
-        glPushMatrix();
+        // object's x/y location is center-based, as are the corners
+        double gx, gy, gz;
+        convertToGlutCoords(x, y, gx, gy, gz);
 
-        double finalWidth = SPRITE_WIDTH_GL * size;
-        double finalHeight = SPRITE_HEIGHT_GL * size;
+          // The four directions use the precomputed corners; any other angle
+          // is rotated here
+        GLfloat corners[8];
+        const GLfloat* unit = corners;
+        GLfloat scale = static_cast<GLfloat>(size);
+        if (angleDegrees >= 0 && angleDegrees < 360 && angleDegrees % 90 == 0)
+            unit = m_corners[angleDegrees / 90];
+        else
+        {
+            computeCorners(angleDegrees, size, corners);
+            scale = 1;
+        }
 
-        // object's x/y location is center-based, but sprite plotting is upper-left-corner based
-        const double xoffset = 0;// finalWidth / 2;
-        const double yoffset = 0;// finalHeight / 2;
+        const GLfloat u[4] = { sprite.u0, sprite.u1, sprite.u1, sprite.u0 };
+        const GLfloat v[4] = { sprite.v0, sprite.v0, sprite.v1, sprite.v1 };
+        for (int k = 0; k < 4; k++)
+        {
+            Vertex vertex = { u[k], v[k],
+                              static_cast<GLfloat>(gx) + scale * unit[2*k],
+                              static_cast<GLfloat>(gy) + scale * unit[2*k + 1],
+                              static_cast<GLfloat>(gz) };
+            m_batch.push_back(vertex);
+        }
 
-        double gx, gy, gz;
-        convertToGlutCoords(x, y, gx, gy, gz);
-        glTranslatef(static_cast<GLfloat>(gx-xoffset),static_cast<GLfloat>(gy-yoffset),static_cast<GLfloat>(gz));
-        glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        return true;
+    }
+
+      // Draws the sprites added since the last call, in the order they were
+      // added, in one draw call, and empties the batch
+    void drawBatch()
+    {
+        if (m_batch.empty())
+            return;
+
+        glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_ENABLE_BIT | GL_CURRENT_BIT);
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
         glEnable(GL_TEXTURE_2D);
         glDisable(GL_DEPTH_TEST);
         glEnable (GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glBindTexture(GL_TEXTURE_2D, it->second);
+        glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
 
         glColor3f(1.0, 1.0, 1.0);
 
-        double cx1 = 0, cy1 = 0;
-        double cx2 = 1, cy2 = 0;
-        double cx3 = 1, cy3 = 1;
-        double cx4 = 0, cy4 = 1;
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &m_batch[0].u);
+        glVertexPointer(3, GL_FLOAT, sizeof(Vertex), &m_batch[0].x);
+        glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(m_batch.size()));
 
-          // Rotate sprite.  For 180 degrees, don't rotate, but reflect
-        double rx1, ry1, rx2, ry2, rx3, ry3, rx4, ry4;
-        double rotationAngle = (angleDegrees == 180 ? 0 : angleDegrees);
-        rotate(-finalWidth / 2, -finalHeight / 2, rotationAngle, rx1, ry1);
-        rotate( finalWidth / 2, -finalHeight / 2, rotationAngle, rx2, ry2);
-        rotate( finalWidth / 2,  finalHeight / 2, rotationAngle, rx3, ry3);
-        rotate(-finalWidth / 2,  finalHeight / 2, rotationAngle, rx4, ry4);
-        if (angleDegrees == 180)
-        {
-            // No rotation happened, but reflect to face left
-            std::swap(rx1, rx2);
-            std::swap(rx3, rx4);
-        }
+        glPopClientAttrib();
+        glPopAttrib();
 
-        glBegin(GL_QUADS);
-        glTexCoord2d(cx1, cy1);
-        glVertex3f(static_cast<GLfloat>(rx1), static_cast<GLfloat>(ry1), 0);
-        glTexCoord2d(cx2, cy2);
-        glVertex3f(static_cast<GLfloat>(rx2), static_cast<GLfloat>(ry2), 0);
-        glTexCoord2d(cx3, cy3);
-        glVertex3f(static_cast<GLfloat>(rx3), static_cast<GLfloat>(ry3), 0);
-        glTexCoord2d(cx4, cy4);
-        glVertex3f(static_cast<GLfloat>(rx4), static_cast<GLfloat>(ry4), 0);
-        glEnd();
-
-        glDisable(GL_TEXTURE_2D);
-        glEnable(GL_DEPTH_TEST);
+        m_batch.clear();    // keeps its capacity for the next frame
+    }
 
-        glPopAttrib();
-        glPopMatrix();
+    bool plotSprite(int imageID, int frame, double x, double y, int angleDegrees, double size)
+    {
+        if (!addSprite(imageID, frame, x, y, angleDegrees, size))
+            return false;
 
+        drawBatch();
         return true;
     }
 
     ~SpriteManager()
     {
-        for (auto it = m_imageMap.begin(); it != m_imageMap.end(); it++)
-            glDeleteTextures(1, &it->second);
+        if (m_atlasTexture != 0)
+            glDeleteTextures(1, &m_atlasTexture);
     }
 
 private:
 
-    std::map<int, GLuint>   m_imageMap;
+      // A loaded frame, and where it is in the atlas
+    struct Sprite
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> pixels;  // BGRA, row by row
+        int x = 0;                          // position in the atlas, in texels
+        int y = 0;
+        GLfloat u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+    };
+
+      // One corner of a quad in the batch, laid out for the vertex arrays
+    struct Vertex
+    {
+        GLfloat u, v;
+        GLfloat x, y, z;
+    };
+
+    std::map<int, Sprite>   m_sprites;
     std::map<int, int>      m_frameCountPerSprite;
     bool                    m_mipMapped;
+    GLuint                  m_atlasTexture;
+    int                     m_atlasWidth;
+    int                     m_atlasHeight;
+    GLfloat                 m_corners[4][8];    // x, y of each corner of a size 1 sprite, by direction / 90
+    std::vector<Vertex>     m_batch;
 
     static const int INVALID_SPRITE_ID = -1;
     static const int MAX_IMAGES = 1000;
     static const int MAX_FRAMES_PER_SPRITE = 100;
+    static const int ATLAS_MIPMAP_LEVELS = 2;                       // smallest mipmap used is 1/4 size
+    static const int ATLAS_PADDING = 1 << ATLAS_MIPMAP_LEVELS;      // gutter texels around each sprite
 
     static int getSpriteID(int imageID, int frame)
     {
@@ -227,6 +376,12 @@ private:
         return imageID * MAX_FRAMES_PER_SPRITE + frame;
     }
 
+      // Texels a sprite of n texels takes up along one side of the atlas
+    static int paddedSize(int n)
+    {
+        return (n + 2 * ATLAS_PADDING + ATLAS_PADDING - 1) / ATLAS_PADDING * ATLAS_PADDING;
+    }
+
     static void rotate(double x, double y, double degrees, double &xout, double &yout)
     {
         static const double PI = 4 * atan(1.0);
@@ -235,6 +390,32 @@ private:
         yout = y * cos(theta) + x * sin(theta);
     }
 
+      // Puts the x, y offsets from a sprite's center of its corners, in the
+      // order of the texture's (0,0), (1,0), (1,1), (0,1), into corners
+    static void computeCorners(int angleDegrees, double size, GLfloat corners[8])
+    {
+        double finalWidth = SPRITE_WIDTH_GL * size;
+        double finalHeight = SPRITE_HEIGHT_GL * size;
+
+          // Rotate sprite.  For 180 degrees, don't rotate, but reflect
+        double rx1, ry1, rx2, ry2, rx3, ry3, rx4, ry4;
+        double rotationAngle = (angleDegrees == 180 ? 0 : angleDegrees);
+        rotate(-finalWidth / 2, -finalHeight / 2, rotationAngle, rx1, ry1);
+        rotate( finalWidth / 2, -finalHeight / 2, rotationAngle, rx2, ry2);
+        rotate( finalWidth / 2,  finalHeight / 2, rotationAngle, rx3, ry3);
+        rotate(-finalWidth / 2,  finalHeight / 2, rotationAngle, rx4, ry4);
+        if (angleDegrees == 180)
+        {
+            // No rotation happened, but reflect to face left
+            std::swap(rx1, rx2);
+            std::swap(rx3, rx4);
+        }
+
+        const double r[8] = { rx1, ry1, rx2, ry2, rx3, ry3, rx4, ry4 };
+        for (int i = 0; i < 8; i++)
+            corners[i] = static_cast<GLfloat>(r[i]);
+    }
+
     static void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz)
     {
         x /= VIEW_WIDTH;
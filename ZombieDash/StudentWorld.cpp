@@ -2,20 +2,27 @@
 #include "GameConstants.h"
 #include "Level.h"
 #include "Actor.h"
+#include "Profiler.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
 #include <climits>
+#include <algorithm>
 using namespace std;
 
 GameWorld* createStudentWorld(string assetPath) {return new StudentWorld(assetPath);}
 
 // Constructor
-StudentWorld::StudentWorld(string assetPath) : GameWorld(assetPath), m_actors(), m_penelope(NULL), m_levelComplete(false) {}
+StudentWorld::StudentWorld(string assetPath) : GameWorld(assetPath), m_actors(), m_joined(0), m_penelope(NULL), m_levelComplete(false), m_width(VIEW_WIDTH), m_height(VIEW_HEIGHT), m_grid(VIEW_WIDTH, VIEW_HEIGHT), m_terrain(VIEW_WIDTH, VIEW_HEIGHT), m_zones(VIEW_WIDTH, VIEW_HEIGHT, 10), m_flowField(VIEW_WIDTH, VIEW_HEIGHT), m_flowFieldCurrent(false), m_zombieField(VIEW_WIDTH, VIEW_HEIGHT, 2*SPRITE_WIDTH), m_pool(), m_ticks(0) {
+    for (int p = 0; p < POPULATIONS; p++)
+        m_alive[p] = 0;
+}
 
 // Main Functions
-StudentWorld::~StudentWorld() {cleanUp();}
+StudentWorld::~StudentWorld() {
+    cleanUp();
+}
 
 int StudentWorld::init() {
     Level level(assetPath());
@@ -43,56 +50,85 @@ int StudentWorld::init() {
     }
     else {
         cerr << "Successfully loaded level " << to_string(getLevel()) << "!" << endl;
+        beginLevel(level.width()*SPRITE_WIDTH, level.height()*SPRITE_HEIGHT);
         Level::MazeEntry ge;
-        for (int x = 0; x < LEVEL_WIDTH; x++) {
-            for (int y = 0; y < LEVEL_HEIGHT; y++) {
+        for (int x = 0; x < level.width(); x++) {
+            for (int y = 0; y < level.height(); y++) {
                 ge = level.getContentsOf(x, y);
                 switch (ge) {
                     case Level::empty:
                         break;
                     case Level::smart_zombie:
-                        m_actors.push_back(new SmartZombie(x*SPRITE_HEIGHT, y*SPRITE_WIDTH, this));
+                        spawn<SmartZombie>(x*SPRITE_HEIGHT, y*SPRITE_WIDTH);
                         break;
                     case Level::dumb_zombie:
-                        m_actors.push_back(new Zombie(x*SPRITE_HEIGHT, y*SPRITE_WIDTH, this));
+                        spawn<Zombie>(x*SPRITE_HEIGHT, y*SPRITE_WIDTH);
                         break;
                     case Level::player:
-                        m_penelope = new Penelope(x*SPRITE_WIDTH, y*SPRITE_HEIGHT, this);
+                        addPenelope(x*SPRITE_WIDTH, y*SPRITE_HEIGHT);
                         break;
                     case Level::citizen:
-                        m_actors.push_back(new Citizen(x*SPRITE_WIDTH, y*SPRITE_HEIGHT, this));
+                        spawn<Citizen>(x*SPRITE_WIDTH, y*SPRITE_HEIGHT);
                         break;
                     case Level::exit:
-                        m_actors.push_back(new Exit(x*SPRITE_WIDTH, y*SPRITE_HEIGHT, this));
+                        spawn<Exit>(x*SPRITE_WIDTH, y*SPRITE_HEIGHT);
                         break;
                     case Level::wall:
-                        m_actors.push_back(new Wall(x*SPRITE_WIDTH, y*SPRITE_HEIGHT, this));
+                        spawn<Wall>(x*SPRITE_WIDTH, y*SPRITE_HEIGHT);
                         break;
                     case Level::pit:
-                        m_actors.push_back(new Pit(x*SPRITE_WIDTH, y*SPRITE_HEIGHT, this));
+                        spawn<Pit>(x*SPRITE_WIDTH, y*SPRITE_HEIGHT);
                         break;
                     case Level::vaccine_goodie:
-                        m_actors.push_back(new VaccineGoodie(x*SPRITE_WIDTH, y*SPRITE_HEIGHT, this));
+                        spawn<VaccineGoodie>(x*SPRITE_WIDTH, y*SPRITE_HEIGHT);
                         break;
                     case Level::gas_can_goodie:
-                        m_actors.push_back(new GasCanGoodie(x*SPRITE_WIDTH, y*SPRITE_HEIGHT, this));
+                        spawn<GasCanGoodie>(x*SPRITE_WIDTH, y*SPRITE_HEIGHT);
                         break;
                     case Level::landmine_goodie:
-                        m_actors.push_back(new LandmineGoodie(x*SPRITE_WIDTH, y*SPRITE_HEIGHT, this));
+                        spawn<LandmineGoodie>(x*SPRITE_WIDTH, y*SPRITE_HEIGHT);
                         break;
                 }
             }
         }
     }
+    finishLoading();
     return GWSTATUS_CONTINUE_GAME;
 }
 
 int StudentWorld::move() {
+    PROFILE_PHASE("StudentWorld::move");
+    // Smart zombies share one flow field per tick, built when first needed
+    m_flowFieldCurrent = false;
+    m_ticks++;
+    m_timers.advance(m_ticks);
+    
     // Tell each actor to do something
-    m_penelope->doSomething();
-    for (int i = 0; i < m_actors.size(); i++) {
-        if (m_actors[i]->alive())
-            m_actors[i]->doSomething();
+    m_zones.beginTick();
+    {
+        PROFILE_PHASE("Penelope::doSomething");
+        m_penelope->doSomething();
+    }
+    if (m_pool) {
+        PROFILE_PHASE("prepareActors");
+        prepareActors();
+    }
+    int a = 0;
+    for (;;) {
+        // Take whichever of the next actor and next awake trigger joined first
+        Actor* next = m_zones.takeTurn(a < m_actors.size() ? m_actorOrder[a] : LONG_MAX);
+        bool trigger = next != NULL;
+        if (!trigger) {
+            if (a == m_actors.size()) break;
+            next = m_actors[a++];
+        }
+        if (next->alive()) {
+            PROFILE_CLASS(*next);
+            next->doSomething();
+        }
+        // A trigger sleeps once nobody is left on it
+        if (trigger)
+            m_zones.finishTurn(next->alive() && overlapOfType(next->getX(), next->getY(), Actor::PIT_DESTRUCTIBLE));
         // Check if Penelope is still alive
         if (!m_penelope->alive()) {
             decLives();
@@ -101,16 +137,24 @@ int StudentWorld::move() {
         // Check if Penelope has completed the level
         if (m_levelComplete) return GWSTATUS_FINISHED_LEVEL;
     }
+    m_zones.endTick();
     
-    // Delete all dead actors
-    for (int i = 0; i < m_actors.size(); i++) {
-        if (!m_actors[i]->alive()) {
-            delete m_actors[i];
-            m_actors.erase(m_actors.begin() + i--);
-        }
+    // Delete all dead actors; inert ones never die
+    {
+        PROFILE_PHASE("removeDead");
+        for (int p = 0; p < POPULATIONS; p++)
+            m_members[p].erase(remove_if(m_members[p].begin(), m_members[p].end(), [](Actor* actor) {return !actor->alive();}), m_members[p].end());
+        removeDead(m_actors, &m_actorOrder);
+        removeDead(m_triggers, NULL);
+    }
+    // Actors spawned this tick take part from the next one on
+    {
+        PROFILE_PHASE("mergeSpawned");
+        mergeSpawned();
     }
     
     // Update the status text
+    PROFILE_PHASE("status text");
     ostringstream statusTextStream;
     statusTextStream.fill('0');
     if (getScore() < 0)
@@ -129,17 +173,196 @@ int StudentWorld::move() {
 }
 
 void StudentWorld::cleanUp() {
-    while (m_actors.size() > 0) {
-        delete m_actors[0];
-        m_actors.erase(m_actors.begin());
+    // Destroy every actor, which takes it off the render list and cancels its timers, before forgetting the sets
+    vector<Actor*>* sets[] = {&m_actors, &m_triggers, &m_inert, &m_spawned};
+    for (int s = 0; s < 4; s++)
+        for (int i = 0; i < sets[s]->size(); i++)
+            (*sets[s])[i]->dispose();
+    if (m_penelope != NULL) m_penelope->dispose();
+    m_actors.clear();
+    m_actorOrder.clear();
+    m_triggers.clear();
+    m_inert.clear();
+    m_joined = 0;
+    m_spawned.clear();
+    for (int p = 0; p < POPULATIONS; p++) {
+        m_members[p].clear();
+        m_alive[p] = 0;
     }
-    delete m_penelope;
+    m_grid.clear();
+    m_terrain.clear();
+    m_zones.clear();
+    m_flowField.clear();
+    m_zombieField.clear();
+    m_arena.reset();
     m_penelope = NULL;
     m_levelComplete = false;
 }
 
+void StudentWorld::getWorldSize(int& width, int& height) const {
+    width = m_width;
+    height = m_height;
+}
+
+void StudentWorld::getCameraTarget(double& x, double& y) const {
+    x = m_penelope != NULL ? m_penelope->getX() : m_width / 2.0;
+    y = m_penelope != NULL ? m_penelope->getY() : m_height / 2.0;
+}
+
+string StudentWorld::statsText() const {
+    ostringstream stats;
+    stats << "flame pool: " << m_flamePool.inUse() << " in use, high water " << m_flamePool.highWater() << ", capacity " << m_flamePool.capacity() << endl;
+    stats << "vomit pool: " << m_vomitPool.inUse() << " in use, high water " << m_vomitPool.highWater() << ", capacity " << m_vomitPool.capacity() << endl;
+    stats << "update sets: " << m_actors.size() << " active, " << m_triggers.size() << " triggers, " << m_inert.size() << " inert" << endl;
+    stats << "populations: " << m_alive[CITIZENS] << " citizens, " << m_alive[ZOMBIES] << " zombies (" << m_alive[SMART_ZOMBIES] << " smart), "
+          << m_alive[BLOCKERS] << " blockers, " << m_alive[PROJECTILES] << " projectiles" << endl;
+    stats << "trigger zones: " << m_zones.zones() << " registered, " << m_zones.awake() << " awake" << endl;
+    stats << "actor arena: " << m_arena.bytesUsed() << " bytes used, capacity " << m_arena.capacity() << endl;
+    return stats.str();
+}
+
+void StudentWorld::setThreads(int threads) {
+    m_pool.reset(threads > 1 ? new ThreadPool(threads) : NULL);
+}
+
+void StudentWorld::prepareActors() {
+    // The workers only read the world, so anything built lazily must be built before they start
+    updateFlowField();
+    // Each actor draws its random numbers from its own stream, named by when it joined, so the decisions do not depend on which thread makes them
+    std::uint64_t seed = getSeed() + m_ticks * 0x9E3779B97F4A7C15ULL;
+    const int BATCH = 64;
+    int count = m_actors.size();
+    m_pool->parallelFor((count + BATCH - 1) / BATCH, [&](int batch, int) {
+        for (int i = batch * BATCH; i < std::min(count, (batch + 1) * BATCH); i++)
+            m_actors[i]->prepare(seed, m_actorOrder[i]);
+    });
+}
+
+// Level Building Functions
+void StudentWorld::beginLevel(const int width, const int height) {
+    // Everything sized by the world is rebuilt empty, which is only safe while the world has no actors
+    if (width == m_width && height == m_height) return;
+    m_width = width;
+    m_height = height;
+    m_grid = SpatialGrid(width, height);
+    m_terrain = TerrainMap(width, height);
+    m_zones = TriggerZones(width, height, 10);
+    m_flowField = FlowField(width, height);
+    m_zombieField = DistanceField(width, height, 2*SPRITE_WIDTH);
+    renderList().setBounds(width, height);
+}
+
+void StudentWorld::addPenelope(const int x, const int y) {
+    m_penelope = new (m_arena.allocate(sizeof(Penelope))) Penelope(x, y, this);
+    m_penelope->cacheProperties();
+}
+
+void StudentWorld::finishLoading() {mergeSpawned();}
+
 // Actor Creation Helper Functions
-void StudentWorld::addActor(Actor* newActor) {m_actors.push_back(newActor);}
+void StudentWorld::addActor(Actor* newActor) {
+    newActor->cacheProperties();
+    m_spawned.push_back(newActor);
+    int kinds = populations(newActor);
+    for (int p = 0; p < POPULATIONS; p++)
+        if (kinds & (1 << p)) m_alive[p]++;
+    // Fixed actors never move or die, so their blocking only needs recording once, and nothing else looks for them
+    if (newActor->hasProperties(Actor::FIXED)) {
+        m_terrain.insert(newActor);
+        if (newActor->hasProperties(Actor::BLOCKS_MOVEMENT))
+            m_flowField.setBlocked(newActor->getX(), newActor->getY());
+    }
+    else
+        m_grid.insert(newActor);
+    if (kinds & (1 << ZOMBIES)) m_zombieField.insert(newActor);
+    // A person appearing in a trigger's zone wakes it just as walking into it would
+    if (newActor->hasProperties(Actor::PIT_DESTRUCTIBLE))
+        m_zones.enter(newActor->getX(), newActor->getY());
+}
+
+void StudentWorld::mergeSpawned() {
+    for (int i = 0; i < m_spawned.size(); i++) {
+        if (m_spawned[i]->hasProperties(Actor::INERT))
+            m_inert.push_back(m_spawned[i]);
+        else if (!m_spawned[i]->alive()) {
+            m_grid.remove(m_spawned[i]);
+            m_spawned[i]->dispose();
+        }
+        else if (m_spawned[i]->hasProperties(Actor::TRIGGER)) {
+            m_triggers.push_back(m_spawned[i]);
+            m_zones.insert(m_spawned[i], m_joined++);
+        }
+        else {
+            m_actors.push_back(m_spawned[i]);
+            m_actorOrder.push_back(m_joined++);
+            int kinds = populations(m_spawned[i]);
+            for (int p = 0; p < POPULATIONS; p++)
+                if (kinds & (1 << p)) m_members[p].push_back(m_spawned[i]);
+        }
+    }
+    m_spawned.clear();
+}
+
+int StudentWorld::populations(const Actor* actor) const {
+    int kinds = 0;
+    if (actor->hasProperties(Actor::INFECTABLE)) kinds |= 1 << CITIZENS;
+    if ((actor->properties() & (Actor::PIT_DESTRUCTIBLE | Actor::INFECTABLE)) == Actor::PIT_DESTRUCTIBLE) kinds |= 1 << ZOMBIES;
+    if (actor->hasProperties(Actor::SMART)) kinds |= 1 << SMART_ZOMBIES;
+    if ((actor->properties() & (Actor::BLOCKS_MOVEMENT | Actor::FIXED)) == Actor::BLOCKS_MOVEMENT) kinds |= 1 << BLOCKERS;
+    // Projectiles are the only actors that act on their own besides people
+    if ((actor->properties() & (Actor::PIT_DESTRUCTIBLE | Actor::FIXED | Actor::INERT | Actor::TRIGGER)) == 0) kinds |= 1 << PROJECTILES;
+    return kinds;
+}
+
+void StudentWorld::actorDied(Actor* actor) {
+    // Penelope is not counted in any population
+    if (actor == m_penelope) return;
+    int kinds = populations(actor);
+    for (int p = 0; p < POPULATIONS; p++)
+        if (kinds & (1 << p)) m_alive[p]--;
+    if (kinds & (1 << ZOMBIES)) m_zombieField.remove(actor);
+}
+
+void StudentWorld::removeDead(vector<Actor*>& actors, vector<long>* order) {
+    // Slide the living actors down so they keep their order
+    int kept = 0;
+    for (int i = 0; i < actors.size(); i++) {
+        if (actors[i]->alive()) {
+            if (order != NULL) (*order)[kept] = (*order)[i];
+            actors[kept++] = actors[i];
+        }
+        else {
+            m_grid.remove(actors[i]);
+            if (actors[i]->hasProperties(Actor::TRIGGER)) m_zones.remove(actors[i]);
+            actors[i]->dispose();
+        }
+    }
+    actors.resize(kept);
+    if (order != NULL) order->resize(kept);
+}
+
+void StudentWorld::addFlame(const int x, const int y, const Direction dir) {addActor(new (m_flamePool.allocate()) Flame(x, y, dir, this));}
+void StudentWorld::addVomit(const int x, const int y, const Direction dir) {addActor(new (m_vomitPool.allocate()) Vomit(x, y, dir, this));}
+void StudentWorld::releaseFlame(Flame* flame) {m_flamePool.release(flame);}
+void StudentWorld::releaseVomit(Vomit* vomit) {m_vomitPool.release(vomit);}
+void StudentWorld::releaseActor(Actor* actor) {
+    actor->~Actor();
+    m_arena.release(actor);
+}
+
+void StudentWorld::actorMoved(Actor* actor, const double oldX, const double oldY) {
+    // Penelope is tracked separately and is not in the grid
+    if (actor != m_penelope) m_grid.move(actor, oldX, oldY);
+    if (populations(actor) & (1 << ZOMBIES)) m_zombieField.move(actor, oldX, oldY);
+    // People are what triggers act on, so only their moves can wake one
+    if (actor->hasProperties(Actor::PIT_DESTRUCTIBLE)) m_zones.enter(actor->getX(), actor->getY());
+}
+
+void StudentWorld::schedule(TimerWheel::Timer& timer, Actor* owner, const int delay) {m_timers.schedule(timer, owner, m_ticks + delay);}
+void StudentWorld::rebuildFlowField() {
+    m_flowField.invalidate();
+    updateFlowField();
+}
 
 // Goodie Adjustment Helper Functions
 void StudentWorld::adjustLandmines(const int num) {m_penelope->adjustLandmines(num);}
@@ -153,43 +376,48 @@ bool StudentWorld::boundaryBoxIntersect(int x1, int y1, int x2, int y2) const {
 }
 
 bool StudentWorld::isValidDestination(const int x, const int y, const Actor* actor) const {
+    // Walls are the most common obstacle, and take only a few bit tests to rule out
+    if (m_terrain.findNear(x, y, SPRITE_WIDTH-2, Actor::BLOCKS_MOVEMENT, [=](int otherX, int otherY) {return boundaryBoxIntersect(x, y, otherX, otherY);}))
+        return false;
     if (actor != m_penelope)
         if (boundaryBoxIntersect(x, y, m_penelope->getX(), m_penelope->getY()))
             return false;
-    for (int i = 0; i < m_actors.size(); i++)
-        if (m_actors[i]->blocksMovement() && m_actors[i]->alive() && m_actors[i] != actor)
-            if (boundaryBoxIntersect(x, y, m_actors[i]->getX(), m_actors[i]->getY()))
-                return false;
-    return true;
+    // Intersecting bounding boxes are always in neighboring cells
+    return m_grid.findNear(x, y, 1, Actor::BLOCKS_MOVEMENT, [=](Actor* other) {
+        return other->hasProperties(Actor::BLOCKS_MOVEMENT) && other->alive() && other != actor && boundaryBoxIntersect(x, y, other->getX(), other->getY());
+    }) == NULL;
 }
 
-double StudentWorld::distance(int x1, int y1, int x2, int y2) const {
-    return pow(pow(x1-x2,2) + pow(y1-y2, 2), 0.5);
+double StudentWorld::distance(int x1, int y1, int x2, int y2) const {return sqrt(distSquared(x1, y1, x2, y2));}
+long long StudentWorld::distSquared(int x1, int y1, int x2, int y2) const {
+    long long dx = x1 - x2;
+    long long dy = y1 - y2;
+    return dx*dx + dy*dy;
 }
 
-bool StudentWorld::overlap(int x1, int y1, int x2, int y2) const {
-    return (distance(x1, y1, x2, y2) <= 10) ? true : false;
-}
+// Comparing squares of whole numbers gives exactly the same answer as comparing their square roots
+bool StudentWorld::withinDistance(int x1, int y1, int x2, int y2, int radius) const {return distSquared(x1, y1, x2, y2) <= static_cast<long long>(radius)*radius;}
+
+bool StudentWorld::overlap(int x1, int y1, int x2, int y2) const {return withinDistance(x1, y1, x2, y2, 10);}
 
 void StudentWorld::exitCitizens(int x, int y) {
-    // For each citizen, check if the citizen overlaps the exit
-    for (int i = 0; i < m_actors.size(); i++) {
-        if (m_actors[i]->alive() && m_actors[i]->infectable()) {
-            if (overlap(x, y, m_actors[i]->getX(), m_actors[i]->getY())) {
+    // For each nearby citizen, check if the citizen overlaps the exit
+    m_grid.forEachNear(x, y, 1, Actor::INFECTABLE, [=](Actor* other) {
+        if (other->alive() && other->hasProperties(Actor::INFECTABLE)) {
+            if (overlap(x, y, other->getX(), other->getY())) {
                 increaseScore(500);
-                m_actors[i]->setDead();
+                other->setDead();
                 playSound(SOUND_CITIZEN_SAVED);
             }
         }
-    }
+    });
 }
 
 void StudentWorld::exitPenelope(int x, int y) {
     // Check if Penelope overlaps with the exit
     if (!overlap(x, y, m_penelope->getX(), m_penelope->getY())) return;
     // Check if there are any remaining live citizens
-    for (int i = 0; i < m_actors.size(); i++)
-        if (m_actors[i]->alive() && m_actors[i]->infectable()) return;
+    if (m_alive[CITIZENS] > 0) return;
     playSound(SOUND_LEVEL_FINISHED);
     m_levelComplete = true;
 }
@@ -199,70 +427,102 @@ bool StudentWorld::overlapGoodie(const int x, const int y) const {
 }
 
 // Destroy Actor Functions
-void StudentWorld::destroyOfType(const int x, const int y, bool (Actor::*property)() const) {
-    if (m_penelope->alive() && (m_penelope->*property)() && overlap(x, y, m_penelope->getX(), m_penelope->getY()))
+void StudentWorld::destroyOfType(const int x, const int y, const int properties) {
+    if (m_penelope->alive() && m_penelope->hasProperties(properties) && overlap(x, y, m_penelope->getX(), m_penelope->getY()))
         m_penelope->destroy();
-    for (int i = 0; i < m_actors.size(); i++)
-        if (m_actors[i]->alive() && (m_actors[i]->*property)())
-            if (overlap(x, y, m_actors[i]->getX(), m_actors[i]->getY()))
-                m_actors[i]->destroy();
+    // Collect the matches first, since destroying an actor may add new actors to the grid
+    vector<Actor*> matches;
+    m_grid.forEachNear(x, y, 1, properties, [&](Actor* other) {
+        if (other->alive() && other->hasProperties(properties) && overlap(x, y, other->getX(), other->getY()))
+            matches.push_back(other);
+    });
+    for (int i = 0; i < matches.size(); i++)
+        if (matches[i]->alive())
+            matches[i]->destroy();
 }
 
 void StudentWorld::infectInfectables(const int x, const int y) {
-    for (int i = 0; i < m_actors.size(); i++)
-        if (m_actors[i]->alive() && m_actors[i]->infectable())
-            if (overlap(x, y, m_actors[i]->getX(), m_actors[i]->getY()))
-                m_actors[i]->infect();
+    m_grid.forEachNear(x, y, 1, Actor::INFECTABLE, [=](Actor* other) {
+        if (other->alive() && other->hasProperties(Actor::INFECTABLE) && overlap(x, y, other->getX(), other->getY()))
+            other->infect();
+    });
     if (m_penelope->alive() && overlap(x, y, m_penelope->getX(), m_penelope->getY()))
         m_penelope->infect();
 }
 
 double StudentWorld::distPenelope(const int x, const int y) const {return distance(x, y, m_penelope->getX(), m_penelope->getY());}
+bool StudentWorld::withinDistPenelope(const int x, const int y, const int radius) const {return withinDistance(x, y, m_penelope->getX(), m_penelope->getY(), radius);}
 double StudentWorld::distZombie(const int x, const int y) const {
-    int min = INT_MAX;
-    for (int i = 0; i < m_actors.size(); i++) {
-        if (m_actors[i]->alive() && m_actors[i]->pitDestructible() && !m_actors[i]->infectable()) {
-            double dist = distance(x, y, m_actors[i]->getX(), m_actors[i]->getY());
-            if (dist < min) min = dist;
-        }
-    }
-    return min;
+    // Citizens only flee zombies less than 81 pixels away (80 in whole pixels), and then compare the spots 2 pixels away,
+    // which are less than 83 pixels from the nearest zombie; every distance up to 83 is exact, and any farther are out of reach
+    double dist;
+    if (!m_zombieField.nearest(x, y, 83, dist)) return INT_MAX;
+    // Distances are compared in whole pixels
+    return static_cast<int>(dist);
 }
 
+long StudentWorld::ticks() const {return m_ticks;}
+int StudentWorld::width() const {return m_width;}
+int StudentWorld::height() const {return m_height;}
+int StudentWorld::population(const Population kind) const {return m_alive[kind];}
 int StudentWorld::penelopeX() const {return m_penelope->getX();}
 int StudentWorld::penelopeY() const {return m_penelope->getY();}
 
-Direction StudentWorld::smartDirection(const int x, const int y) const {
-    Actor* target = m_penelope;
-    int min = distPenelope(x, y);
-    for (int i = 0; i < m_actors.size(); i++) {
-        if (m_actors[i]->alive() && m_actors[i]->infectable()) {
-            double dist = distance(x, y, m_actors[i]->getX(), m_actors[i]->getY());
-            if (dist < min) {
-                min = dist;
-                target = m_actors[i];
-            }
-        }
-    }
-    if (min > 80) return randDirection();
-    else {
+Direction StudentWorld::smartDirection(const int x, const int y, int& distance, RandomGenerator& rng) {
+    if (!m_flowFieldCurrent) updateFlowField();
+    // Only targets within 80 pixels of walking matter
+    int steps, targetX, targetY;
+    Direction dir;
+    if (!m_flowField.lookup(x, y, steps, dir, targetX, targetY)) return randDirection(rng);
+    if (steps == 0) {
         // If target is on the same row or column as zombie
-        if (x == target->getX())
-            return(y > target->getY() ? GraphObject::down : GraphObject::up);
-        else if (y == target->getY())
-            return(x > target->getX() ? GraphObject::left : GraphObject::right);
+        if (x == targetX)
+            return(y > targetY ? GraphObject::down : GraphObject::up);
+        else if (y == targetY)
+            return(x > targetX ? GraphObject::left : GraphObject::right);
         else {
             // Otherwise, randomly try one of the two directions to move closer to target
-            if (randInt(0, 1) == 0)
-                return x > target->getX() ? GraphObject::left : GraphObject::right;
+            if (rng.randInt(0, 1) == 0)
+                return x > targetX ? GraphObject::left : GraphObject::right;
             else
-                return y > target->getY() ? GraphObject::down : GraphObject::up;
+                return y > targetY ? GraphObject::down : GraphObject::up;
         }
     }
+    // Line up with the zombie's cell before heading along the path, so the walls beside it do not get in the way
+    int cellX = (x + SPRITE_WIDTH/2) / SPRITE_WIDTH * SPRITE_WIDTH;
+    int cellY = (y + SPRITE_HEIGHT/2) / SPRITE_HEIGHT * SPRITE_HEIGHT;
+    if ((dir == GraphObject::right || dir == GraphObject::left) && y != cellY) {
+        distance = std::min(distance, abs(y - cellY));
+        return y > cellY ? GraphObject::down : GraphObject::up;
+    }
+    if ((dir == GraphObject::up || dir == GraphObject::down) && x != cellX) {
+        distance = std::min(distance, abs(x - cellX));
+        return x > cellX ? GraphObject::left : GraphObject::right;
+    }
+    return dir;
 }
 
-Direction StudentWorld::randDirection() const {
-    switch (randInt(1,4)) {
+void StudentWorld::updateFlowField() {
+    vector<int> targetX, targetY;
+    if (m_penelope->alive()) {
+        targetX.push_back(m_penelope->getX());
+        targetY.push_back(m_penelope->getY());
+    }
+    const vector<Actor*>& citizens = m_members[CITIZENS];
+    for (int i = 0; i < citizens.size(); i++) {
+        if (citizens[i]->alive()) {
+            targetX.push_back(citizens[i]->getX());
+            targetY.push_back(citizens[i]->getY());
+        }
+    }
+    m_flowField.build(targetX, targetY, 80/std::min(SPRITE_WIDTH, SPRITE_HEIGHT));
+    m_flowFieldCurrent = true;
+}
+
+Direction StudentWorld::randDirection() {return randDirection(aiRandom());}
+
+Direction StudentWorld::randDirection(RandomGenerator& rng) {
+    switch (rng.randInt(1,4)) {
         case 1: return(GraphObject::right);
         case 2: return(GraphObject::left);
         case 3: return(GraphObject::up);
@@ -271,12 +531,13 @@ Direction StudentWorld::randDirection() const {
     return GraphObject::right;
 }
 
-bool StudentWorld::overlapOfType(const int x, const int y, bool (Actor::*property)() const) {
-    if (m_penelope->alive() && (m_penelope->*property)() && overlap(x, y, m_penelope->getX(), m_penelope->getY()))
+bool StudentWorld::overlapOfType(const int x, const int y, const int properties) {
+    // Flames and vomit are only ever stopped by walls and exits
+    if (m_terrain.findNear(x, y, 10, properties, [=](int otherX, int otherY) {return overlap(x, y, otherX, otherY);}))
         return true;
-    for (int i = 0; i < m_actors.size(); i++)
-        if (m_actors[i]->alive() && (m_actors[i]->*property)())
-            if (overlap(x, y, m_actors[i]->getX(), m_actors[i]->getY()))
-                return true;
-    return false;
+    if (m_penelope->alive() && m_penelope->hasProperties(properties) && overlap(x, y, m_penelope->getX(), m_penelope->getY()))
+        return true;
+    return m_grid.findNear(x, y, 1, properties, [=](Actor* other) {
+        return other->alive() && other->hasProperties(properties) && overlap(x, y, other->getX(), other->getY());
+    }) != NULL;
 }
@@ -3,14 +3,36 @@
 
 #include "GameWorld.h"
 #include "GraphObject.h"
+#include "SpatialGrid.h"
+#include "TerrainMap.h"
+#include "TriggerZones.h"
+#include "TimerWheel.h"
+#include "FlowField.h"
+#include "DistanceField.h"
+#include "ObjectPool.h"
+#include "Arena.h"
+#include "ThreadPool.h"
 #include <vector>
 #include <string>
+#include <memory>
 
 class Actor;
 class Penelope;
+class Flame;
+class Vomit;
 
 class StudentWorld : public GameWorld {
 public:
+    // Kinds of actors kept track of apart from the rest; an actor may be of several kinds, or none
+    enum Population {
+        CITIZENS,       // Infectable people other than Penelope
+        ZOMBIES,        // People that are not infectable, dumb or smart
+        SMART_ZOMBIES,  // Zombies that find their way around walls
+        BLOCKERS,       // Actors that block movement and may move, which are the people other than Penelope
+        PROJECTILES,    // Flames and vomit
+        POPULATIONS     // Number of kinds
+    };
+    
     // Constructor
     StudentWorld(std::string assetPath);
     
@@ -21,37 +43,101 @@ public:
     virtual int     init();     // Loads information from the level data file
     virtual int     move();     // Makes each actor do something, and then deletes dead actors
     virtual void    cleanUp();  // Deletes all actors
+    virtual void setThreads(int threads); // Decides what zombies and citizens do on this many threads before they act (1 or less acts one at a time)
+    virtual std::string statsText() const; // Reports how far the projectile pools and the actor arena have grown
+    virtual void getWorldSize(int& width, int& height) const; // Gets the size of the current level in pixels
+    virtual void getCameraTarget(double& x, double& y) const; // Gets where Penelope is, for the camera to follow, or the middle of the level between levels
+    
+    // Level Building: init() builds each level from its data file with these, and they can also build a level without one
+    void beginLevel(const int width, const int height); // Sizes the world to width x height pixels for a new level; only called while it has no actors
+    void addPenelope(const int x, const int y); // Creates Penelope at (x, y)
+    void finishLoading(); // Has the actors added so far join their update sets, ready for the first tick
     
     // Mutators
-    void addActor(Actor* newActor); // Adds an actor to m_actors
-    void destroyOfType(const int x, const int y, bool (Actor::*property)() const); // Destroys all actors overlapping (x, y) satisfying given property
+    // Spawning: an added actor is in the grid or terrain map (and so seen by every query) and drawn at once, but it only joins
+    // its update set, and so first acts, once the current tick is over; init() merges its actors before the first tick
+    void addActor(Actor* newActor); // Adds an actor to the spawn buffer
+    template<typename T>
+    T* spawn(const int x, const int y); // Creates a T at (x, y) in this level's arena and adds it to the world
+    void addFlame(const int x, const int y, const Direction dir); // Adds a flame taken from the flame pool
+    void addVomit(const int x, const int y, const Direction dir); // Adds vomit taken from the vomit pool
+    void releaseFlame(Flame* flame); // Destroys a flame and returns it to the flame pool
+    void releaseVomit(Vomit* vomit); // Destroys vomit and returns it to the vomit pool
+    void releaseActor(Actor* actor); // Destroys any other actor and returns its memory to the arena
+    void destroyOfType(const int x, const int y, const int properties); // Destroys all actors overlapping (x, y) with every property in the Actor::Property mask
     void infectInfectables(const int x, const int y); // Infects all infectables at (x, y)
     void adjustLandmines(const int num);    // Adjusts the number of landmines Penelope is carrying by num
     void adjustFlameCharges(const int num); // Adjusts the number of flamethrower charges Penelope is carrying by num
     void adjustVaccines(const int num);     // Adjusts the number of vaccines Penelope is carrying by num
     void exitCitizens(const int x, const int y); // Detects which overlap with an exit and removes them
     void exitPenelope(const int x, const int y); // Detects and handles whether Penelope has completed the level
+    void actorMoved(Actor* actor, const double oldX, const double oldY); // Updates the spatial grid after an actor moves from (oldX, oldY)
+    void actorDied(Actor* actor); // Takes an actor that has just died out of the live counts of its populations
+    void schedule(TimerWheel::Timer& timer, Actor* owner, const int delay); // Has owner->timerExpired() called at the start of the tick delay ticks from now
+    void rebuildFlowField(); // Rebuilds the smart zombies' flow field from scratch, as the first smartDirection() of a tick does once people have moved
     
     // Accessors
-    bool overlapOfType(const int x, const int y, bool (Actor::*property)() const); // Returns whether an actor satisfying the given property overlaps with (x, y)
+    bool overlapOfType(const int x, const int y, const int properties); // Returns whether an actor with every property in the Actor::Property mask overlaps with (x, y)
     bool overlapGoodie(const int x, const int y) const; // Returns whether Penelope overlaps with a goodie at (x, y)
+    bool boundaryBoxIntersect(int x1, int y1, int x2, int y2) const; // Determines whether bounding boxes with their lower-left corner at (x1, y1) and (x2, y2) intersect
     bool isValidDestination(const int x, const int y, const Actor* actor) const; // Returns whether moving to the specified location is allowed
     double distPenelope(const int x, const int y) const; // Returns the distance to Penelope from (x, y)
-    double distZombie(const int x, const int y) const; // Returns the distance to the nearest zombie from (x, y)
+    bool withinDistPenelope(const int x, const int y, const int radius) const; // Returns whether Penelope is at most radius away from (x, y), without taking a square root
+    double distZombie(const int x, const int y) const; // Returns the distance in whole pixels from (x, y) to the nearest living zombie, or INT_MAX if none is within 83 pixels
+    long ticks() const; // Returns the number of the current tick, counted across levels
+    int width() const;  // Returns the width of the world in pixels
+    int height() const; // Returns the height of the world in pixels
+    int population(const Population kind) const; // Returns the number of live actors of a kind, including any added this tick
     int penelopeX() const; // Returns the x-coordinate of Penelope
     int penelopeY() const; // Returns the y-coordinate of Penelope
-    Direction smartDirection(const int x, const int y) const; // Returns the direction a smart zombie should head from (x, y)
-    Direction randDirection() const; // Returns a random direction
+    Direction smartDirection(const int x, const int y, int& distance, RandomGenerator& rng); // Returns the direction a smart zombie should head from (x, y), shortening distance if it should stop sooner
+    Direction randDirection(); // Returns a random direction drawn from the AI random stream
+    Direction randDirection(RandomGenerator& rng); // Returns a random direction drawn from rng
     
 private:
-    std::vector<Actor*> m_actors;   // Array of pointers to all actors in the game, other than Penelope
+    // Update sets: each tick visits the actors in m_actors and the awake ones in m_triggers together, in the order they joined, and never visits m_inert
+    std::vector<Actor*> m_actors;       // Actors that act on their own (people and projectiles), other than Penelope
+    std::vector<long> m_actorOrder;     // When each actor in m_actors joined, counted across all sets
+    std::vector<Actor*> m_triggers;     // Actors that only act on what is on them (exits, pits, goodies, and landmines), which sleep in m_zones until a person lands on them
+    std::vector<Actor*> m_inert;        // Actors that never do anything (walls)
+    long m_joined;                      // Number of actors that have joined a set this level
+    std::vector<Actor*> m_spawned;      // Actors added during the current tick, which join their set once it is over
+    std::vector<Actor*> m_members[POPULATIONS]; // Actors of each kind in m_actors, in the same order; dead ones stay until the end of the tick
+    int m_alive[POPULATIONS];           // Number of live actors of each kind, counted from when they are added
     Penelope* m_penelope;           // Pointer to Penelope
     bool m_levelComplete;           // Whether the level has been completed
+    int m_width;                    // Size of the world in pixels, which everything below that covers the world is sized to
+    int m_height;
+    Arena m_arena;                  // Storage for all other actors, reused as they die
+    ObjectPool<Flame> m_flamePool;  // Storage for flames, which only live for two ticks
+    ObjectPool<Vomit> m_vomitPool;  // Storage for vomit, which only lives for two ticks
+    SpatialGrid m_grid;             // Buckets of the actors that are not fixed by location, so queries only visit nearby actors
+    TerrainMap m_terrain;           // Where the fixed actors that block things are, filled as the level is loaded
+    TriggerZones m_zones;           // Zones around the actors in m_triggers, and which of them are awake
+    FlowField m_flowField;          // Paths around walls to the nearest infectable, shared by all smart zombies
+    bool m_flowFieldCurrent;        // Whether m_flowField has been built this tick
+    DistanceField m_zombieField;    // Where the living zombies are, kept up to date as they come, move and die, for fleeing citizens
+    std::unique_ptr<ThreadPool> m_pool; // Threads for deciding what zombies and citizens do, or empty to have each decide as it acts
+    long m_ticks;                   // Number of ticks so far, for timers and for seeding the random numbers of decisions made on m_pool
+    TimerWheel m_timers;            // Timers actors are waiting on, which go off as m_ticks reaches them
     
     // Helper Functions
     double distance(int x1, int y1, int x2, int y2) const; // Returns the distance between (x1, y1) and (x2, y2)
-    bool boundaryBoxIntersect(int x1, int y1, int x2, int y2) const; // Determines whether bounding boxes with their lower-left corner at (x1, y1) and (x2, y2) intersect
+    long long distSquared(int x1, int y1, int x2, int y2) const; // Returns the square of the distance between (x1, y1) and (x2, y2), which can be too big for an int on large levels
+    bool withinDistance(int x1, int y1, int x2, int y2, int radius) const; // Returns whether (x1, y1) and (x2, y2) are at most radius apart
     bool overlap(int x1, int y1, int x2, int y2) const; // Determines whether actors at (x1, y1) and (x2, y2) overlap
+    void prepareActors(); // Has every actor decide on m_pool what it will do this tick
+    void mergeSpawned(); // Moves the living actors in m_spawned to the end of their sets, disposing of the dead ones
+    int populations(const Actor* actor) const; // Returns the kinds of actor, one bit per Population
+    void removeDead(std::vector<Actor*>& actors, std::vector<long>* order); // Disposes of the dead actors in an update set, keeping the rest (and their join orders, if given) in order
+    void updateFlowField(); // Rebuilds m_flowField from the current positions of all living infectables
 };
 
+template<typename T>
+T* StudentWorld::spawn(const int x, const int y) {
+    T* actor = new (m_arena.allocate(sizeof(T))) T(x, y, this);
+    addActor(actor);
+    return actor;
+}
+
 #endif // STUDENTWORLD_H_
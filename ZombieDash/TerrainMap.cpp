@@ -0,0 +1,28 @@
+#include "TerrainMap.h"
+#include "Actor.h"
+using namespace std;
+
+const int TerrainMap::LAYER_PROPERTY[TerrainMap::LAYERS] = {Actor::BLOCKS_MOVEMENT, Actor::BLOCKS_FLAMES, Actor::BLOCKS_VOMIT};
+
+// Constructor
+TerrainMap::TerrainMap(int width, int height) : m_cols(max((width + SPRITE_WIDTH - 1) / SPRITE_WIDTH, 1)), m_rows(max((height + SPRITE_HEIGHT - 1) / SPRITE_HEIGHT, 1)), m_words((m_cols + 63) / 64), m_tracked(0) {
+    for (int k = 0; k < LAYERS; k++) {
+        m_bits[k].assign(m_rows * m_words, 0);
+        m_tracked |= LAYER_PROPERTY[k];
+    }
+}
+
+// Mutators
+void TerrainMap::insert(const Actor* actor) {
+    int c = static_cast<int>(actor->getX()) / SPRITE_WIDTH;
+    int r = static_cast<int>(actor->getY()) / SPRITE_HEIGHT;
+    if (c < 0 || c >= m_cols || r < 0 || r >= m_rows) return;
+    for (int k = 0; k < LAYERS; k++)
+        if (actor->hasProperties(LAYER_PROPERTY[k]))
+            m_bits[k][r*m_words + c/64] |= uint64_t(1) << (c%64);
+}
+
+void TerrainMap::clear() {
+    for (int k = 0; k < LAYERS; k++)
+        fill(m_bits[k].begin(), m_bits[k].end(), 0);
+}
@@ -0,0 +1,62 @@
+#ifndef TERRAINMAP_H_
+#define TERRAINMAP_H_
+
+#include "GameConstants.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+class Actor;
+
+/* TerrainMap Class Declaration
+ * - Packed bitmaps, one bit per SPRITE_WIDTH x SPRITE_HEIGHT cell, of where the fixed actors (walls, exits, and pits) that block movement, flames, or vomit are
+ * - Fixed actors are placed on cell corners by the level loader and never move or die, so the map is filled once by init() and never updated
+ * - Blocking checks test a handful of bits here instead of visiting actors, and only the moving actors that block things are left in the SpatialGrid
+ */
+class TerrainMap {
+public:
+    // Constructor
+    TerrainMap(int width, int height); // Creates an empty map covering width x height pixels
+
+    // Mutators
+    void insert(const Actor* actor); // Marks the cell at actor's position with each of its blocking properties
+    void clear();                    // Removes all actors from the map
+
+    // Accessors
+    template<typename Pred>
+    bool findNear(int x, int y, int reach, int mask, Pred pred) const; // Returns whether pred(cellX, cellY) holds for a marked cell, with every property in mask, whose corner is at most reach pixels from (x, y) along each axis
+private:
+    static const int LAYERS = 3;            // Number of blocking properties tracked
+    static const int LAYER_PROPERTY[LAYERS]; // Actor::Property flag tracked by each bitmap
+    int m_cols;  // Number of columns of cells
+    int m_rows;  // Number of rows of cells
+    int m_words; // Number of 64-bit words per row
+    std::vector<std::uint64_t> m_bits[LAYERS]; // One bit per cell for each property, stored row by row
+    int m_tracked; // Union of LAYER_PROPERTY
+
+    // Helper Functions
+    bool marked(int c, int r, int mask) const; // Returns whether the cell in column c and row r has every property in mask
+};
+
+template<typename Pred>
+bool TerrainMap::findNear(int x, int y, int reach, int mask, Pred pred) const {
+    // Only the blocking properties are tracked, so nothing here has any other
+    if (mask == 0 || (mask & ~m_tracked) != 0) return false;
+    if (x + reach < 0 || y + reach < 0) return false;
+    int cMin = (std::max(x - reach, 0) + SPRITE_WIDTH - 1) / SPRITE_WIDTH, cMax = std::min((x + reach) / SPRITE_WIDTH, m_cols - 1);
+    int rMin = (std::max(y - reach, 0) + SPRITE_HEIGHT - 1) / SPRITE_HEIGHT, rMax = std::min((y + reach) / SPRITE_HEIGHT, m_rows - 1);
+    for (int r = rMin; r <= rMax; r++)
+        for (int c = cMin; c <= cMax; c++)
+            if (marked(c, r, mask) && pred(c*SPRITE_WIDTH, r*SPRITE_HEIGHT)) return true;
+    return false;
+}
+
+inline bool TerrainMap::marked(int c, int r, int mask) const {
+    int word = r*m_words + c/64;
+    std::uint64_t bit = std::uint64_t(1) << (c%64);
+    for (int k = 0; k < LAYERS; k++)
+        if ((mask & LAYER_PROPERTY[k]) && !(m_bits[k][word] & bit)) return false;
+    return true;
+}
+
+#endif // TERRAINMAP_H_
@@ -0,0 +1,140 @@
+#include "ThreadPool.h"
+using namespace std;
+
+ThreadPool::ThreadPool(int workers)
+ : m_generation(0), m_busy(0), m_quit(false)
+{
+    if (workers <= 0)
+        workers = max(static_cast<int>(thread::hardware_concurrency()), 1);
+    for (int w = 0; w < workers; w++)
+    {
+        m_ranges.push_back(unique_ptr<Range>(new Range));
+        m_ranges.back()->begin = m_ranges.back()->end = 0;
+    }
+    for (int w = 1; w < workers; w++)
+        m_threads.push_back(thread(&ThreadPool::workerLoop, this, w));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_start.notify_all();
+    for (thread& t : m_threads)
+        t.join();
+}
+
+void ThreadPool::parallelFor(int count, function<void(int, int)> func)
+{
+    if (count <= 0)
+        return;
+
+      // Hand each worker an equal share of [0, count)
+    int n = workers();
+    for (int w = 0; w < n; w++)
+    {
+        lock_guard<mutex> lock(m_ranges[w]->m);
+        m_ranges[w]->begin = static_cast<int>(static_cast<long long>(count) * w / n);
+        m_ranges[w]->end = static_cast<int>(static_cast<long long>(count) * (w + 1) / n);
+    }
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_func = func;
+        m_busy = n - 1;
+        m_generation++;
+    }
+    m_start.notify_all();
+
+    work(0);
+
+    unique_lock<mutex> lock(m_mutex);
+    m_finish.wait(lock, [this] { return m_busy == 0; });
+    m_func = nullptr;
+}
+
+void ThreadPool::workerLoop(int worker)
+{
+    unsigned long seen = 0;
+    for (;;)
+    {
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_start.wait(lock, [&] { return m_quit  ||  m_generation != seen; });
+            if (m_quit)
+                return;
+            seen = m_generation;
+        }
+
+        work(worker);
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_busy--;
+        }
+        m_finish.notify_one();
+    }
+}
+
+void ThreadPool::work(int worker)
+{
+    int index;
+    do
+    {
+        while (take(worker, index))
+            m_func(index, worker);
+    } while (steal(worker));
+}
+
+bool ThreadPool::take(int worker, int& index)
+{
+    Range& r = *m_ranges[worker];
+    lock_guard<mutex> lock(r.m);
+    if (r.begin >= r.end)
+        return false;
+    index = r.begin++;
+    return true;
+}
+
+bool ThreadPool::steal(int worker)
+{
+    for (;;)
+    {
+          // Pick the victim with the most work left
+        int victim = -1;
+        int most = 0;
+        for (int w = 0; w < workers(); w++)
+        {
+            if (w == worker)
+                continue;
+            lock_guard<mutex> lock(m_ranges[w]->m);
+            int left = m_ranges[w]->end - m_ranges[w]->begin;
+            if (left > most)
+            {
+                most = left;
+                victim = w;
+            }
+        }
+        if (victim < 0)
+            return false;
+
+        int begin, end;
+        {
+            Range& v = *m_ranges[victim];
+            lock_guard<mutex> lock(v.m);
+            int left = v.end - v.begin;
+            if (left <= 0)
+                continue;   // someone else got there first; look again
+            end = v.end;
+            begin = v.end - (left + 1) / 2;
+            v.end = begin;
+        }
+        Range& r = *m_ranges[worker];
+        lock_guard<mutex> lock(r.m);
+        r.begin = begin;
+        r.end = end;
+        return true;
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+  // A fixed set of worker threads that run parallelFor() loops.  Each
+  // worker starts with an equal share of the indices and works through it
+  // from the front; a worker that runs out steals the back half of the
+  // largest remaining share.  The thread calling parallelFor() takes part
+  // as worker 0.
+
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(int workers = 0);   // 0 means one per hardware thread
+    ~ThreadPool();
+
+    int workers() const
+    {
+        return static_cast<int>(m_ranges.size());
+    }
+
+      // Calls func(index, worker) once for every index in [0, count) and
+      // returns when all calls have finished
+    void parallelFor(int count, std::function<void(int, int)> func);
+
+      // Prevent copying or assigning ThreadPools
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+  private:
+    struct Range
+    {
+        std::mutex m;
+        int        begin;
+        int        end;
+    };
+
+    std::vector<std::unique_ptr<Range>> m_ranges;
+    std::vector<std::thread>            m_threads;
+    std::mutex                          m_mutex;
+    std::condition_variable             m_start;
+    std::condition_variable             m_finish;
+    std::function<void(int, int)>       m_func;
+    unsigned long                       m_generation;
+    int                                 m_busy;
+    bool                                m_quit;
+
+    void workerLoop(int worker);
+    void work(int worker);
+    bool take(int worker, int& index);
+    bool steal(int worker);
+};
+
+#endif // THREADPOOL_H_
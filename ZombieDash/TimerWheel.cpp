@@ -0,0 +1,77 @@
+#include "TimerWheel.h"
+#include "Actor.h"
+using namespace std;
+
+// Timer Class Implementation
+void TimerWheel::Timer::cancel() {
+    m_prev->m_next = m_next;
+    m_next->m_prev = m_prev;
+    m_prev = m_next = this;
+}
+
+// Constructor
+TimerWheel::TimerWheel() : m_now(0) {}
+
+// Mutators
+void TimerWheel::schedule(Timer& timer, Actor* owner, long expires) {
+    timer.cancel();
+    timer.m_owner = owner;
+    timer.m_expires = expires > m_now ? expires : m_now + 1;
+    place(timer);
+}
+
+void TimerWheel::advance(long tick) {
+    while (m_now < tick) {
+        m_now++;
+        // Each time a level comes round to slot 0, the next level's current slot comes within its range
+        int index = m_now & (SLOTS - 1);
+        for (int level = 1; level < LEVELS && index == 0; level++)
+            index = cascade(level);
+        // Everything left in level 0's current slot is due now; take it all first, since a timer going off may schedule another
+        Timer& slot = m_slots[0][m_now & (SLOTS - 1)];
+        Timer due;
+        splice(slot, due);
+        while (due.pending()) {
+            Timer* timer = due.m_next;
+            timer->cancel();
+            timer->m_owner->timerExpired();
+        }
+    }
+}
+
+// Helper Functions
+void TimerWheel::place(Timer& timer) {
+    long delta = timer.m_expires - m_now;
+    long expires = timer.m_expires;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= 1L << (BITS * (level + 1)))
+        level++;
+    // Too far off for the wheel: wait as far ahead as it goes
+    if (delta >= 1L << (BITS * LEVELS))
+        expires = m_now + (1L << (BITS * LEVELS)) - 1;
+    Timer& slot = m_slots[level][(expires >> (BITS * level)) & (SLOTS - 1)];
+    timer.m_prev = slot.m_prev;
+    timer.m_next = &slot;
+    slot.m_prev->m_next = &timer;
+    slot.m_prev = &timer;
+}
+
+void TimerWheel::splice(Timer& from, Timer& to) {
+    if (!from.pending()) return;
+    to.m_next = from.m_next;
+    to.m_prev = from.m_prev;
+    to.m_next->m_prev = to.m_prev->m_next = &to;
+    from.m_prev = from.m_next = &from;
+}
+
+int TimerWheel::cascade(int level) {
+    int index = (m_now >> (BITS * level)) & (SLOTS - 1);
+    Timer moving;
+    splice(m_slots[level][index], moving);
+    while (moving.pending()) {
+        Timer* timer = moving.m_next;
+        timer->cancel();
+        place(*timer);
+    }
+    return index;
+}
@@ -0,0 +1,56 @@
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include <cstddef>
+
+class Actor;
+
+/* TimerWheel Class Declaration
+ * - Hierarchical timing wheel: LEVELS wheels of SLOTS lists each, where a slot of level l covers SLOTS^l ticks
+ * - Scheduling and cancelling take constant time, and advancing a tick only touches the timers due then, plus one slot of
+ *   a higher level every SLOTS ticks, whose timers are moved down a level as they come within range
+ * - Timers live inside the actors that own them and unlink themselves when destroyed, so a dead actor's timer never goes off
+ * - Timers further off than the wheel covers wait in the furthest slot of the top level and are placed again when it comes round
+ */
+class TimerWheel {
+public:
+    // A wake-up for one actor, kept in a doubly-linked list of the timers in the same slot
+    class Timer {
+    public:
+        Timer() : m_prev(this), m_next(this), m_owner(NULL), m_expires(0) {}
+        ~Timer() {cancel();} // Unschedules the timer
+        bool pending() const {return m_next != this;} // Returns whether the timer is scheduled
+        void cancel();                                // Unschedules the timer, if it is scheduled
+    private:
+        friend class TimerWheel;
+        Timer* m_prev;  // Neighbors in the slot's list, or this timer if it is not scheduled
+        Timer* m_next;
+        Actor* m_owner; // Actor whose timerExpired() is called when the timer goes off
+        long m_expires; // Tick the timer goes off at
+        Timer(const Timer&);            // Not copyable, since the lists point at it
+        Timer& operator=(const Timer&);
+    };
+
+    // Constructor
+    TimerWheel(); // Creates an empty wheel at tick 0
+
+    // Mutators
+    void schedule(Timer& timer, Actor* owner, long expires); // (Re)schedules timer to call owner->timerExpired() once the wheel reaches tick expires, or the next tick if that has passed
+    void advance(long tick); // Moves the wheel forward to tick, setting off every timer due up to then in order of tick
+
+    // Accessors
+    long now() const {return m_now;} // Returns the tick the wheel is at
+private:
+    static const int BITS = 6;              // Number of bits of the tick each level covers
+    static const int SLOTS = 1 << BITS;     // Number of slots per level
+    static const int LEVELS = 4;            // Number of levels
+    Timer m_slots[LEVELS][SLOTS];           // Heads of the lists of timers in each slot, which are never scheduled themselves
+    long m_now;                             // Tick the wheel is at
+
+    // Helper Functions
+    void place(Timer& timer); // Links timer into the slot for its expiry tick, relative to m_now
+    int cascade(int level);   // Moves the timers in level's current slot down to lower levels, returning that slot's index
+    static void splice(Timer& from, Timer& to); // Moves all the timers in the list headed by from to the empty list headed by to
+};
+
+#endif // TIMERWHEEL_H_
@@ -0,0 +1,133 @@
+#include "TriggerZones.h"
+#include "Actor.h"
+#include <cmath>
+#include <climits>
+#include <algorithm>
+#include <functional>
+using namespace std;
+
+// Constructor
+TriggerZones::TriggerZones(int width, int height, int radius) : m_cols(max((width + SPRITE_WIDTH - 1) / SPRITE_WIDTH, 1)), m_rows(max((height + SPRITE_HEIGHT - 1) / SPRITE_HEIGHT, 1)), m_radius(radius), m_cells(m_cols * m_rows), m_zoneCount(0), m_cursor(LONG_MAX), m_current(-1) {}
+
+// Mutators
+void TriggerZones::insert(Actor* trigger, long order) {
+    int zone;
+    if (m_free.empty()) {
+        zone = m_zones.size();
+        m_zones.push_back(Zone());
+    }
+    else {
+        zone = m_free.back();
+        m_free.pop_back();
+    }
+    Zone& z = m_zones[zone];
+    z.trigger = trigger;
+    z.order = order;
+    z.x = trigger->getX();
+    z.y = trigger->getY();
+    // New triggers take their first turn next tick, whether or not anyone is in their zone
+    z.awake = true;
+    m_next.push_back(zone);
+    m_cells[row(z.y)*m_cols + col(z.x)].push_back(zone);
+    m_zoneCount++;
+}
+
+void TriggerZones::remove(Actor* trigger) {
+    int zone = find(trigger);
+    if (zone < 0) return;
+    Zone& z = m_zones[zone];
+    vector<int>& cell = m_cells[row(z.y)*m_cols + col(z.x)];
+    *std::find(cell.begin(), cell.end(), zone) = cell.back();
+    cell.pop_back();
+    // Triggers are only removed between ticks, when the awake ones are all waiting for the next tick
+    if (z.awake) m_next.erase(std::find(m_next.begin(), m_next.end(), zone));
+    z.trigger = NULL;
+    m_free.push_back(zone);
+    m_zoneCount--;
+}
+
+void TriggerZones::clear() {
+    for (int i = 0; i < m_cells.size(); i++)
+        m_cells[i].clear();
+    m_zones.clear();
+    m_free.clear();
+    m_zoneCount = 0;
+    m_queue.clear();
+    m_next.clear();
+    m_cursor = LONG_MAX;
+    m_current = -1;
+}
+
+void TriggerZones::enter(int x, int y) {
+    // Zones are smaller than a cell, so any zone containing (x, y) is centered in a neighboring cell
+    int c = col(x);
+    int r = row(y);
+    for (int j = max(r - 1, 0); j <= min(r + 1, m_rows - 1); j++)
+        for (int i = max(c - 1, 0); i <= min(c + 1, m_cols - 1); i++)
+            for (int zone : m_cells[j*m_cols + i]) {
+                const Zone& z = m_zones[zone];
+                if (!z.awake && (x - z.x)*(x - z.x) + (y - z.y)*(y - z.y) <= m_radius*m_radius)
+                    wake(zone);
+            }
+}
+
+void TriggerZones::beginTick() {
+    m_queue.clear();
+    for (int i = 0; i < m_next.size(); i++)
+        m_queue.push_back(make_pair(m_zones[m_next[i]].order, m_next[i]));
+    m_next.clear();
+    make_heap(m_queue.begin(), m_queue.end(), greater<pair<long, int>>());
+    m_cursor = LONG_MIN;
+}
+
+Actor* TriggerZones::takeTurn(long before) {
+    if (m_queue.empty() || m_queue.front().first >= before) {
+        m_cursor = before;
+        return NULL;
+    }
+    pop_heap(m_queue.begin(), m_queue.end(), greater<pair<long, int>>());
+    m_current = m_queue.back().second;
+    m_queue.pop_back();
+    m_cursor = m_zones[m_current].order;
+    return m_zones[m_current].trigger;
+}
+
+void TriggerZones::finishTurn(bool awake) {
+    if (awake)
+        m_next.push_back(m_current);
+    else
+        m_zones[m_current].awake = false;
+}
+
+void TriggerZones::endTick() {m_cursor = LONG_MAX;}
+
+// Accessors
+int TriggerZones::awake() const {return m_queue.size() + m_next.size();}
+
+// Helper Functions
+int TriggerZones::col(double x) const {
+    int c = static_cast<int>(floor(x / SPRITE_WIDTH));
+    return c < 0 ? 0 : (c >= m_cols ? m_cols - 1 : c);
+}
+
+int TriggerZones::row(double y) const {
+    int r = static_cast<int>(floor(y / SPRITE_HEIGHT));
+    return r < 0 ? 0 : (r >= m_rows ? m_rows - 1 : r);
+}
+
+int TriggerZones::find(Actor* trigger) const {
+    const vector<int>& cell = m_cells[row(trigger->getY())*m_cols + col(trigger->getX())];
+    for (int i = 0; i < cell.size(); i++)
+        if (m_zones[cell[i]].trigger == trigger) return cell[i];
+    return -1;
+}
+
+void TriggerZones::wake(int zone) {
+    m_zones[zone].awake = true;
+    if (m_zones[zone].order > m_cursor) {
+        m_queue.push_back(make_pair(m_zones[zone].order, zone));
+        push_heap(m_queue.begin(), m_queue.end(), greater<pair<long, int>>());
+    }
+    else
+        m_next.push_back(zone);
+}
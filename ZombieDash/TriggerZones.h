@@ -0,0 +1,62 @@
+#ifndef TRIGGERZONES_H_
+#define TRIGGERZONES_H_
+
+#include "GameConstants.h"
+#include <vector>
+#include <utility>
+
+class Actor;
+
+/* TriggerZones Class Declaration
+ * - Zones of a fixed radius around trigger actors (exits, pits, goodies, and landmines), bucketed by SPRITE_WIDTH x SPRITE_HEIGHT cell
+ * - A trigger only has anything to do while a person is in its zone, so it sleeps until a person lands in it and wakes it up
+ * - Awake triggers take their turns in the order they joined the world; one woken after its turn this tick waits for the next tick
+ * - A trigger stays awake after its turn only if asked to, so sleeping triggers cost nothing however many there are
+ */
+class TriggerZones {
+public:
+    // Constructor
+    TriggerZones(int width, int height, int radius); // Creates an empty set of zones of the given radius covering width x height pixels
+
+    // Mutators
+    void insert(Actor* trigger, long order);    // Registers a zone around trigger, which joined the world in the given order; it starts awake
+    void remove(Actor* trigger);                // Unregisters trigger's zone, forgetting it if it is awake
+    void clear();                               // Removes all zones
+    void enter(int x, int y);                   // Wakes every trigger whose zone contains (x, y)
+    void beginTick();                           // Queues up the triggers that are awake for their turns this tick
+    Actor* takeTurn(long before);               // Returns the next queued trigger if it joined before order before, or else NULL as the actor with that order takes its turn
+    void finishTurn(bool awake);                // Keeps the trigger returned by the last takeTurn() awake for the next tick, or puts it to sleep
+    void endTick();                             // Sends any trigger woken from now on to the next tick
+
+    // Accessors
+    bool queued() const {return !m_queue.empty();} // Returns whether any triggers are still waiting for their turn this tick
+    int zones() const {return m_zoneCount;}         // Returns the number of registered zones
+    int awake() const;                              // Returns the number of awake triggers
+private:
+    // A registered trigger
+    struct Zone {
+        Actor* trigger; // Trigger actor, or NULL if this slot is free
+        long order;     // When the trigger joined the world
+        int x, y;       // Center of the zone
+        bool awake;     // Whether the trigger is queued for this tick or the next
+    };
+    int m_cols;     // Number of columns of cells
+    int m_rows;     // Number of rows of cells
+    int m_radius;   // Radius of every zone
+    std::vector<std::vector<int>> m_cells;  // Indices into m_zones of the zones centered in each cell, stored row by row
+    std::vector<Zone> m_zones;  // All zones, including free slots
+    std::vector<int> m_free;    // Free slots in m_zones
+    int m_zoneCount;            // Number of registered zones
+    std::vector<std::pair<long, int>> m_queue; // Orders and indices of the awake zones taking their turns this tick, as a heap with the earliest first
+    std::vector<int> m_next;    // Awake zones taking their turns next tick
+    long m_cursor;              // Order of the actor whose turn was last taken this tick; triggers before it wake for the next tick
+    int m_current;              // Zone of the trigger returned by the last takeTurn()
+
+    // Helper Functions
+    int col(double x) const; // Returns the column of the cell containing x, clamped to the grid
+    int row(double y) const; // Returns the row of the cell containing y, clamped to the grid
+    int find(Actor* trigger) const; // Returns the index in m_zones of trigger's zone, or -1
+    void wake(int zone); // Queues the zone for this tick or the next, depending on whether its turn has passed
+};
+
+#endif // TRIGGERZONES_H_
@@ -0,0 +1,211 @@
+#include "HeadlessController.h"
+#include "GameWorld.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+
+  // Runs many independent games in parallel, one StudentWorld per job, e.g.
+  //     ZombieDashBatch -a Assets -j jobs.txt -w 8 -t 20000 > results.csv
+  // -a  directory containing the level data files (default "Assets")
+  // -j  job file with one "<level> <seed> [keyScript]" job per line; blank
+  //     lines and lines starting with '#' are ignored
+  // -w  number of worker threads (default: one per hardware thread)
+  // -t  maximum number of ticks per job (default 100000)
+  // Each job starts at the given level and runs until that level is
+  // finished, the game is over, or it runs out of ticks.  Results are
+  // written as CSV, followed by a summary per worker.
+
+GameWorld* createStudentWorld(string assetPath = "");
+
+struct Job
+{
+    int                 level;
+    unsigned long long  seed;
+    string              scriptFile;
+};
+
+struct JobResult
+{
+    string  outcome;
+    int     score;
+    int     lives;
+    long    ticks;
+    double  seconds;
+    int     worker;
+};
+
+struct WorkerStats
+{
+    int     jobs;
+    long    ticks;
+    double  seconds;
+};
+
+static void usage()
+{
+    cout << "usage: ZombieDashBatch -j jobFile [-a assetDirectory] [-w workers] [-t maxTicks]" << endl;
+}
+
+static bool loadJobs(string filename, vector<Job>& jobs)
+{
+    ifstream jobFile(filename);
+    if (!jobFile)
+        return false;
+
+    string line;
+    while (getline(jobFile, line))
+    {
+        if (line.find_first_not_of(" \t\r") == string::npos  ||  line[0] == '#')
+            continue;
+        istringstream iss(line);
+        Job job;
+        if (!(iss >> job.level >> job.seed)  ||  job.level < 1)
+            return false;
+        iss >> job.scriptFile;
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+static string outcomeName(const HeadlessController& controller, int status)
+{
+    if (!controller.done())
+        return "timeout";
+    switch (status)
+    {
+        case GWSTATUS_FINISHED_LEVEL:   return "finished";
+        case GWSTATUS_PLAYER_DIED:      return "gameover";
+        case GWSTATUS_PLAYER_WON:       return "won";
+        case GWSTATUS_LEVEL_ERROR:      return "error";
+    }
+    return "quit";
+}
+
+int main(int argc, char* argv[])
+{
+    string assetPath = "Assets";
+    string jobsFile;
+    int workers = 0;
+    long maxTicks = 100000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 1;
+        }
+        if (arg == "-a")
+            assetPath = argv[++i];
+        else if (arg == "-j")
+            jobsFile = argv[++i];
+        else if (arg == "-w")
+            workers = atoi(argv[++i]);
+        else if (arg == "-t")
+            maxTicks = atol(argv[++i]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (jobsFile.empty())
+    {
+        usage();
+        return 1;
+    }
+    if (!assetPath.empty()  &&  assetPath.back() != '/')
+        assetPath += '/';
+
+    vector<Job> jobs;
+    if (!loadJobs(jobsFile, jobs))
+    {
+        cout << "Cannot load job file " << jobsFile << endl;
+        return 1;
+    }
+
+      // Load each key script once; the jobs only ever read them
+    map<string, unique_ptr<KeyScript>> scripts;
+    for (const Job& job : jobs)
+    {
+        if (job.scriptFile.empty()  ||  scripts.count(job.scriptFile))
+            continue;
+        unique_ptr<KeyScript> script(new KeyScript);
+        if (!script->load(job.scriptFile))
+        {
+            cout << "Cannot load key script " << job.scriptFile << endl;
+            return 1;
+        }
+        scripts[job.scriptFile] = move(script);
+    }
+
+      // Look up each job's script before the workers start, so they never
+      // touch the map
+    vector<KeySource*> jobKeys(jobs.size(), nullptr);
+    for (size_t k = 0; k < jobs.size(); k++)
+        if (!jobs[k].scriptFile.empty())
+            jobKeys[k] = scripts.at(jobs[k].scriptFile).get();
+
+    ThreadPool pool(workers);
+    vector<JobResult> results(jobs.size());
+    vector<WorkerStats> stats(pool.workers(), WorkerStats{ 0, 0, 0 });
+
+    auto start = chrono::steady_clock::now();
+    pool.parallelFor(static_cast<int>(jobs.size()), [&](int index, int worker)
+    {
+        const Job& job = jobs[index];
+        GameWorld* gw = createStudentWorld(assetPath);
+        gw->setSeed(job.seed);
+        for (int level = 1; level < job.level; level++)
+            gw->advanceToNextLevel();
+
+        HeadlessController controller(gw, jobKeys[index]);
+        controller.setStopAtLevelEnd(true);
+        int status = controller.run(maxTicks);
+
+        JobResult& r = results[index];
+        r.outcome = outcomeName(controller, status);
+        r.score = gw->getScore();
+        r.lives = gw->getLives();
+        r.ticks = controller.ticks();
+        r.seconds = controller.seconds();
+        r.worker = worker;
+        delete gw;
+
+        stats[worker].jobs++;
+        stats[worker].ticks += r.ticks;
+        stats[worker].seconds += r.seconds;
+    });
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "job,level,seed,script,outcome,score,lives,ticks,worker,seconds" << endl;
+    for (size_t k = 0; k < jobs.size(); k++)
+    {
+        const Job& job = jobs[k];
+        const JobResult& r = results[k];
+        cout << k << ',' << job.level << ',' << job.seed << ',' << job.scriptFile << ','
+             << r.outcome << ',' << r.score << ',' << r.lives << ',' << r.ticks << ','
+             << r.worker << ',' << r.seconds << endl;
+    }
+
+    long totalTicks = 0;
+    cout << endl << "worker,jobs,ticks,seconds,ticks/sec" << endl;
+    for (size_t w = 0; w < stats.size(); w++)
+    {
+        const WorkerStats& s = stats[w];
+        cout << w << ',' << s.jobs << ',' << s.ticks << ',' << s.seconds << ','
+             << (s.seconds > 0 ? s.ticks / s.seconds : 0) << endl;
+        totalTicks += s.ticks;
+    }
+    cout << endl << "total," << jobs.size() << ',' << totalTicks << ',' << seconds << ','
+         << (seconds > 0 ? totalTicks / seconds : 0) << endl;
+}
@@ -0,0 +1,443 @@
+#include "GameWorld.h"
+#include "GameConstants.h"
+#include "RandomGenerator.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+using namespace std;
+
+#ifdef _MSC_VER
+#include <windows.h>
+#include <psapi.h>
+#include <direct.h>
+#pragma comment(lib, "psapi.lib")
+static bool makeDirectory(string path)
+{
+    DWORD result = GetFileAttributes(path.c_str());
+    if (result != INVALID_FILE_ATTRIBUTES)
+        return (result & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    return _mkdir(path.c_str()) == 0;
+}
+
+static long peakResidentKB()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+}
+#else
+#include <sys/stat.h>
+#include <sys/resource.h>
+static bool makeDirectory(string path)
+{
+    struct stat statbuf;
+    if (stat(path.c_str(), &statbuf) == 0)
+        return S_ISDIR(statbuf.st_mode);
+    return mkdir(path.c_str(), 0755) == 0;
+}
+
+static long peakResidentKB()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;    // bytes on macOS
+#else
+    return usage.ru_maxrss;           // kilobytes elsewhere
+#endif
+}
+#endif
+
+  // Runs StudentWorld::move() on synthetic crowded levels and reports the
+  // throughput of each as JSON, so runs can be compared across commits, e.g.
+  //     ZombieDashBenchmark -t 2000 -s 1 > results.json
+  // -d  directory to write the generated levels to (default
+  //     "benchmark-levels", created if missing)
+  // -t  number of ticks to run each scenario for (default 2000)
+  // -s  seed for both the level layouts and the game (default 1)
+  // -x  fraction of the free cells each scenario crowds with actors
+  //     (default 0.5)
+  // -n  width and height of the levels in cells (default LEVEL_WIDTH)
+  // -w  number of threads each world may use (default 1)
+  // -o  run only the named scenario
+  // The scenarios are citizens (citizens with a few zombies among them),
+  // horde (dumb zombies), smart (smart zombies), landmines (Penelope
+  // dropping landmines in front of a horde, which go off in chains) and
+  // maze (a mixed crowd in a maze of walls).  Penelope follows a fixed key
+  // pattern, and whenever she dies or finishes, the level starts over, so
+  // every scenario runs for the full number of ticks.  Only move() is
+  // timed.  Peak RSS is the process's high-water mark after the scenario,
+  // so it never goes down from one scenario to the next.
+
+GameWorld* createStudentWorld(string assetPath = "");
+
+static const char* const scenarioNames[] = { "citizens", "horde", "smart", "landmines", "maze" };
+static const int NUM_SCENARIOS = sizeof(scenarioNames) / sizeof(scenarioNames[0]);
+
+  // A level laid out as one character per cell, in the Level file format,
+  // with row 0 at the bottom
+
+class LevelLayout
+{
+  public:
+    LevelLayout(int width, int height)
+     : m_width(width), m_height(height), m_cells(height, string(width, ' '))
+    {
+        for (int x = 0; x < width; x++)
+            m_cells[0][x] = m_cells[height-1][x] = '#';
+        for (int y = 0; y < height; y++)
+            m_cells[y][0] = m_cells[y][width-1] = '#';
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    int height() const
+    {
+        return m_height;
+    }
+
+    char& at(int x, int y)
+    {
+        return m_cells[y][x];
+    }
+
+      // Each empty cell, in a random order
+    vector<pair<int, int>> shuffledEmptyCells(RandomGenerator& rng) const
+    {
+        vector<pair<int, int>> cells;
+        for (int y = 0; y < m_height; y++)
+            for (int x = 0; x < m_width; x++)
+                if (m_cells[y][x] == ' ')
+                    cells.push_back(make_pair(x, y));
+        for (int k = static_cast<int>(cells.size()) - 1; k > 0; k--)
+            swap(cells[k], cells[rng.randInt(0, k)]);
+        return cells;
+    }
+
+    int actors() const
+    {
+        int count = 0;
+        for (int y = 0; y < m_height; y++)
+            for (int x = 0; x < m_width; x++)
+                if (m_cells[y][x] != ' ')
+                    count++;
+        return count;
+    }
+
+      // Levels of the default size are written without a size line, so
+      // that older builds can run them too
+    bool write(string filename) const
+    {
+        ofstream levelFile(filename);
+        if (m_width != LEVEL_WIDTH  ||  m_height != LEVEL_HEIGHT)
+            levelFile << m_width << ' ' << m_height << '\n';
+        for (int y = m_height - 1; y >= 0; y--)
+            levelFile << m_cells[y] << '\n';
+        return static_cast<bool>(levelFile);
+    }
+
+  private:
+    int            m_width;
+    int            m_height;
+    vector<string> m_cells;
+};
+
+  // Fills the interior with walls and carves a maze out of it, with its
+  // corridors on the odd rows and columns
+
+static void carveMaze(LevelLayout& layout, RandomGenerator& rng)
+{
+    for (int y = 1; y < layout.height() - 1; y++)
+        for (int x = 1; x < layout.width() - 1; x++)
+            layout.at(x, y) = '#';
+
+    const int dx[] = { 2, -2, 0, 0 };
+    const int dy[] = { 0, 0, 2, -2 };
+    vector<pair<int, int>> path(1, make_pair(1, 1));
+    layout.at(1, 1) = ' ';
+    while (!path.empty())
+    {
+        int x = path.back().first;
+        int y = path.back().second;
+        int choices[4];
+        int n = 0;
+        for (int d = 0; d < 4; d++)
+        {
+            int nx = x + dx[d];
+            int ny = y + dy[d];
+            if (nx > 0  &&  nx < layout.width() - 1  &&  ny > 0  &&  ny < layout.height() - 1  &&  layout.at(nx, ny) == '#')
+                choices[n++] = d;
+        }
+        if (n == 0)
+        {
+            path.pop_back();
+            continue;
+        }
+        int d = choices[rng.randInt(0, n-1)];
+        layout.at(x + dx[d]/2, y + dy[d]/2) = ' ';
+        layout.at(x + dx[d], y + dy[d]) = ' ';
+        path.push_back(make_pair(x + dx[d], y + dy[d]));
+    }
+}
+
+static LevelLayout makeLayout(int scenario, int size, double crowd, RandomGenerator& rng)
+{
+    LevelLayout layout(size, size);
+    int w = layout.width();
+    int h = layout.height();
+    string scenarioName = scenarioNames[scenario];
+
+    if (scenarioName == "landmines")
+    {
+          // Penelope walks back and forth along a row of landmine goodies
+          // below the horde
+        layout.at(1, 1) = '@';
+        for (int x = 2; x < w - 1; x++)
+            layout.at(x, 1) = 'L';
+        for (int x = 1; x < w - 1; x++)
+            layout.at(x, 2) = '.';
+    }
+    else if (scenarioName == "maze")
+    {
+        carveMaze(layout, rng);
+        layout.at(1, 1) = '@';
+    }
+    else
+        layout.at(w/2, h/2) = '@';
+
+      // The exit goes in the far corner, or the first free cell before it
+    bool placedExit = false;
+    for (int y = h - 2; y > 0  &&  !placedExit; y--)
+        for (int x = w - 2; x > 0  &&  !placedExit; x--)
+            if (layout.at(x, y) == ' ')
+            {
+                layout.at(x, y) = 'X';
+                placedExit = true;
+            }
+
+    vector<pair<int, int>> cells = layout.shuffledEmptyCells(rng);
+    int count = static_cast<int>(cells.size() * crowd);
+    for (int k = 0; k < count; k++)
+    {
+        char& cell = layout.at(cells[k].first, cells[k].second);
+        if (scenarioName == "citizens")
+            cell = (k % 8 == 7 ? 'D' : 'C');
+        else if (scenarioName == "horde")
+            cell = 'D';
+        else if (scenarioName == "smart")
+            cell = 'S';
+        else if (scenarioName == "landmines")
+            cell = (k % 3 == 2 ? 'L' : 'D');
+        else
+            cell = "CDS"[k % 3];
+    }
+
+      // Cells kept clear of the crowd go back to being empty
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+            if (layout.at(x, y) == '.')
+                layout.at(x, y) = ' ';
+    return layout;
+}
+
+  // Feeds Penelope a fixed pattern of keys: in the landmine scenario she
+  // walks back and forth dropping a landmine every other tick; otherwise
+  // she walks in a square
+
+class BenchmarkController : public WorldController
+{
+  public:
+    BenchmarkController(bool landmines, int width)
+     : m_landmines(landmines), m_width(width), m_tick(0)
+    {
+    }
+
+    void setTick(long tick)
+    {
+        m_tick = tick;
+    }
+
+    virtual bool getLastKey(int& value)
+    {
+        const int square[] = { KEY_PRESS_RIGHT, KEY_PRESS_UP, KEY_PRESS_LEFT, KEY_PRESS_DOWN };
+        if (!m_landmines)
+            value = square[(m_tick / 16) % 4];
+        else if (m_tick % 2 == 1)
+            value = KEY_PRESS_TAB;
+        else
+            value = ((m_tick / (8 * m_width)) % 2 == 0 ? KEY_PRESS_RIGHT : KEY_PRESS_LEFT);
+        return true;
+    }
+
+    virtual void playSound(int /* soundID */)
+    {
+    }
+
+    virtual void setGameStatText(string /* text */)
+    {
+    }
+
+    virtual void quitGame()
+    {
+    }
+
+  private:
+    bool m_landmines;
+    int  m_width;
+    long m_tick;
+};
+
+struct ScenarioResult
+{
+    int     actors;
+    long    ticks;
+    long    restarts;
+    double  seconds;
+    double  actorTicks;
+    long    peakKB;
+};
+
+static bool runScenario(int scenario, string levelDir, int size, long ticks, unsigned long long seed,
+                        double crowd, int threads, ScenarioResult& result)
+{
+    RandomGenerator rng(seed, scenario);
+    LevelLayout layout = makeLayout(scenario, size, crowd, rng);
+    if (!layout.write(levelDir + "level01.txt"))
+    {
+        cerr << "Cannot write " << levelDir << "level01.txt" << endl;
+        return false;
+    }
+
+    GameWorld* gw = createStudentWorld(levelDir);
+    gw->setSeed(seed);
+    gw->setThreads(threads);
+    BenchmarkController controller(string(scenarioNames[scenario]) == "landmines", size);
+    gw->setController(&controller);
+
+    result = ScenarioResult{ layout.actors(), 0, 0, 0, 0, 0 };
+    if (gw->init() != GWSTATUS_CONTINUE_GAME)
+    {
+        cerr << "Cannot load the " << scenarioNames[scenario] << " level" << endl;
+        delete gw;
+        return false;
+    }
+    for ( ; result.ticks < ticks; result.ticks++)
+    {
+        controller.setTick(result.ticks);
+        result.actorTicks += gw->renderList().size();
+        auto start = chrono::steady_clock::now();
+        int status = gw->move();
+        result.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (status != GWSTATUS_CONTINUE_GAME)
+        {
+            gw->cleanUp();
+            gw->init();
+            result.restarts++;
+        }
+    }
+    gw->cleanUp();
+    delete gw;
+    result.peakKB = peakResidentKB();
+    return true;
+}
+
+static void usage()
+{
+    cout << "usage: ZombieDashBenchmark [-d levelDirectory] [-t ticks] [-s seed] [-x crowd]" << endl;
+    cout << "                           [-n size] [-w threads] [-o scenario]" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    string levelDir = "benchmark-levels";
+    long ticks = 2000;
+    unsigned long long seed = 1;
+    double crowd = 0.5;
+    int size = LEVEL_WIDTH;
+    int threads = 1;
+    string only;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 1;
+        }
+        if (arg == "-d")
+            levelDir = argv[++i];
+        else if (arg == "-t")
+            ticks = atol(argv[++i]);
+        else if (arg == "-s")
+            seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "-x")
+            crowd = atof(argv[++i]);
+        else if (arg == "-n")
+            size = atoi(argv[++i]);
+        else if (arg == "-w")
+            threads = atoi(argv[++i]);
+        else if (arg == "-o")
+            only = argv[++i];
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (ticks < 1  ||  crowd < 0  ||  crowd > 1  ||  size < 4  ||  size > MAX_LEVEL_WIDTH  ||  size > MAX_LEVEL_HEIGHT)
+    {
+        usage();
+        return 1;
+    }
+    if (!makeDirectory(levelDir))
+    {
+        cout << "Cannot create directory " << levelDir << endl;
+        return 1;
+    }
+    if (levelDir.back() != '/')
+        levelDir += '/';
+
+    ostringstream json;
+    json << "{" << endl;
+    json << "  \"seed\": " << seed << "," << endl;
+    json << "  \"ticks\": " << ticks << "," << endl;
+    json << "  \"crowd\": " << crowd << "," << endl;
+    json << "  \"threads\": " << threads << "," << endl;
+    json << "  \"scenarios\": [";
+    int run = 0;
+    for (int scenario = 0; scenario < NUM_SCENARIOS; scenario++)
+    {
+        if (!only.empty()  &&  only != scenarioNames[scenario])
+            continue;
+        ScenarioResult r = { 0, 0, 0, 0, 0, 0 };
+        if (!runScenario(scenario, levelDir, size, ticks, seed, crowd, threads, r))
+            return 1;
+        json << (run++ > 0 ? "," : "") << endl;
+        json << "    { \"name\": \"" << scenarioNames[scenario] << "\""
+             << ", \"width\": " << size << ", \"height\": " << size
+             << ", \"actors\": " << r.actors
+             << ", \"ticks\": " << r.ticks
+             << ", \"restarts\": " << r.restarts
+             << ", \"seconds\": " << r.seconds
+             << ", \"ticks_per_sec\": " << (r.seconds > 0 ? r.ticks / r.seconds : 0)
+             << ", \"ns_per_actor_tick\": " << (r.actorTicks > 0 ? r.seconds * 1e9 / r.actorTicks : 0)
+             << ", \"peak_rss_kb\": " << r.peakKB << " }";
+    }
+    if (run == 0)
+    {
+        cout << "Unknown scenario " << only << endl;
+        return 1;
+    }
+    json << endl << "  ]" << endl << "}" << endl;
+    cout << json.str();
+}
@@ -0,0 +1,153 @@
+#include "HeadlessController.h"
+#include "GameWorld.h"
+#include "Replay.h"
+#include "Profiler.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+using namespace std;
+
+  // Runs Zombie Dash without a window as fast as the CPU allows, e.g.
+  //     ZombieDashHeadless -a Assets -t 100000 -k keys.txt -s 42
+  // -a  directory containing the level data files (default "Assets")
+  // -t  number of ticks to run, or -1 to run until the game ends (default -1)
+  // -k  key script to take the player's input from (default: no input)
+  // -s  seed for the world's random streams (default: a random seed)
+  // -r  record the run to a replay file
+  // -p  play back a replay file (recorded here or with ZombieDash -r); its
+  //     seed and keys replace -s and -k, and -t fast-forwards to that tick
+  // -w  number of threads zombies and citizens decide their moves on
+  //     (default 1).  Any number above 1 gives the same game for a given
+  //     seed, but not the same game as 1.  Replay files do not record the
+  //     number, and the game always records them on one thread, so -r and
+  //     -p force a single thread whatever -w says.
+
+GameWorld* createStudentWorld(string assetPath = "");
+
+static void usage()
+{
+    cout << "usage: ZombieDashHeadless [-a assetDirectory] [-t ticks] [-k keyScript] [-s seed]" << endl;
+    cout << "                          [-r replayFile] [-p replayFile] [-w threads]" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    string assetPath = "Assets";
+    long maxTicks = -1;
+    string scriptFile;
+    string seed;
+    string recordFile;
+    string playFile;
+    int threads = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 1;
+        }
+        if (arg == "-a")
+            assetPath = argv[++i];
+        else if (arg == "-t")
+            maxTicks = atol(argv[++i]);
+        else if (arg == "-k")
+            scriptFile = argv[++i];
+        else if (arg == "-s")
+            seed = argv[++i];
+        else if (arg == "-r")
+            recordFile = argv[++i];
+        else if (arg == "-p")
+            playFile = argv[++i];
+        else if (arg == "-w")
+            threads = atoi(argv[++i]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (!assetPath.empty()  &&  assetPath.back() != '/')
+        assetPath += '/';
+    {
+        const string someAsset = "level01.txt";
+        ifstream ifs(assetPath + someAsset);
+        if (!ifs)
+        {
+            cout << "Cannot find " << someAsset << " in " << assetPath << endl;
+            return 1;
+        }
+    }
+
+    KeyScript script;
+    if (!scriptFile.empty()  &&  !script.load(scriptFile))
+    {
+        cout << "Cannot load key script " << scriptFile << endl;
+        return 1;
+    }
+
+    ReplayPlayer player;
+    if (!playFile.empty())
+    {
+        if (!player.load(playFile))
+        {
+            cout << "Cannot load replay file " << playFile << endl;
+            return 1;
+        }
+        if (maxTicks < 0  ||  maxTicks > player.ticks())
+            maxTicks = player.ticks();
+    }
+
+    if (threads > 1  &&  (!recordFile.empty()  ||  !playFile.empty()))
+    {
+        cerr << "Recording and replaying run on one thread; ignoring -w " << threads << endl;
+        threads = 1;
+    }
+
+    GameWorld* gw = createStudentWorld(assetPath);
+    gw->setThreads(threads);
+    KeySource* keys = nullptr;
+    if (!playFile.empty())
+    {
+        gw->setSeed(player.seed());
+        keys = &player;
+    }
+    else
+    {
+        if (!seed.empty())
+            gw->setSeed(strtoull(seed.c_str(), nullptr, 10));
+        if (!scriptFile.empty())
+            keys = &script;
+    }
+
+    HeadlessController controller(gw, keys);
+    ReplayRecorder recorder;
+    if (!recordFile.empty())
+    {
+        if (!recorder.open(recordFile, gw->getSeed()))
+        {
+            cout << "Cannot create replay file " << recordFile << endl;
+            delete gw;
+            return 1;
+        }
+        controller.setRecorder(&recorder);
+    }
+    controller.run(maxTicks);
+    recorder.close();
+
+    cout << "seed: " << gw->getSeed() << endl;
+    cout << "ticks: " << controller.ticks() << endl;
+    cout << "seconds: " << controller.seconds() << endl;
+    cout << "ticks/sec: " << controller.ticksPerSecond() << endl;
+    cout << "level: " << gw->getLevel() << "  lives: " << gw->getLives()
+         << "  score: " << gw->getScore() << endl;
+    cout << controller.gameStatText() << endl;
+    cout << gw->statsText();
+    PROFILE_REPORT(cout);
+    if (!playFile.empty()  &&  player.desynced())
+        cout << "warning: replay diverged from the recording" << endl;
+    delete gw;
+}
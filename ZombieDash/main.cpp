@@ -1,6 +1,9 @@
 #include "GameController.h"
+#include "GameWorld.h"
+#include "Replay.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 using namespace std;
 
@@ -26,10 +29,19 @@ bool is_directory(string path)
 
 const string assetDirectory = "Assets"; 
 
-class GameWorld;
-
 GameWorld* createStudentWorld(string assetPath = "");
 
+  // Passing "-r replayFile" records the session so that it can be played
+  // back with ZombieDashHeadless -p replayFile.  Passing "-v WIDTHxHEIGHT"
+  // shows a window of that many pixels of the world around Penelope
+  // (default 256x256, one screen), scaled to fill the screen; it must have
+  // the screen's shape, since sprites are scaled the same both ways.
+
+static void usage()
+{
+    cout << "usage: ZombieDash [-r replayFile] [-v WIDTHxHEIGHT]" << endl;
+}
+
 int main(int argc, char* argv[])
 {
     string assetPath = assetDirectory;
@@ -53,6 +65,51 @@ int main(int argc, char* argv[])
         }
     }
 
+    string recordFile;
+    for (int i = 1; i < argc; i++)
+    {
+          // Anything else is left for GLUT (e.g. -geometry) or the system
+        string arg = argv[i];
+        if (arg != "-r"  &&  arg != "-v")
+            continue;
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 1;
+        }
+        if (arg == "-r")
+            recordFile = argv[++i];
+        else
+        {
+            int viewWidth, viewHeight;
+            char x;
+            istringstream viewSize(argv[++i]);
+            if (!(viewSize >> viewWidth >> x >> viewHeight)  ||  x != 'x'  ||  viewWidth < 1  ||  viewHeight < 1)
+            {
+                cout << "Bad viewport size " << argv[i] << endl;
+                return 1;
+            }
+            if (static_cast<long long>(viewWidth) * VIEW_HEIGHT != static_cast<long long>(viewHeight) * VIEW_WIDTH)
+            {
+                cout << "Viewport " << argv[i] << " is not the shape of the " << VIEW_WIDTH << "x"
+                     << VIEW_HEIGHT << " screen" << endl;
+                return 1;
+            }
+            Game().setViewport(viewWidth, viewHeight);
+        }
+    }
+
     GameWorld* gw = createStudentWorld(assetPath);
+    ReplayRecorder recorder;
+    if (!recordFile.empty())
+    {
+        if (!recorder.open(recordFile, gw->getSeed()))
+        {
+            cout << "Cannot create replay file " << recordFile << endl;
+            delete gw;
+            return 1;
+        }
+        Game().setRecorder(&recorder);
+    }
     Game().run(argc, argv, gw, "Zombie Dash");
 }
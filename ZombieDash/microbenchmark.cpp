@@ -0,0 +1,374 @@
+#include "StudentWorld.h"
+#include "Actor.h"
+#include "Profiler.h"
+#include "RandomGenerator.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+using namespace std;
+
+  // Times StudentWorld's queries one call at a time on worlds built in code
+  // with 10 to 100000 actors, e.g.
+  //     ZombieDashMicrobenchmark -n 5000 -t 0.15
+  // -n  number of calls timed per query and world (default 5000)
+  // -s  seed for the worlds and the query points (default 1)
+  // -p  largest population (default 100000); worlds have 10, 100, ...
+  //     actors up to that
+  // -b  file of the scaling slopes to compare against (default
+  //     ZombieDash/microbenchmarkBaseline.txt, relative to the top of the
+  //     repository)
+  // -t  how far above its baseline slope a query's slope may be (default
+  //     0.15)
+  // -u  rewrite the baseline file with the slopes measured, instead of
+  //     comparing against it
+  // Each world has one actor for every four cells, so the actors near any
+  // point are about the same at every size, and a query that only looks
+  // near its point should take about as long whatever the population.  A
+  // query's scaling slope is that of the least-squares line through
+  // log(median latency) against log(population): 0 is constant time and 1
+  // linear.  Bigger worlds miss the cache more often, which alone gives
+  // local queries slopes of up to about 0.3, and some work, like building
+  // the flow field, grows with the population by design, so rather than
+  // hold every query to one limit, the benchmark compares each slope with
+  // the one recorded for that query in the baseline.  If any query's slope
+  // is more than the tolerance above its baseline, the benchmark says so
+  // and exits with status 1; rerun with -u after a change that is meant to
+  // change how a query scales.  Each call is timed on its own, so every
+  // latency includes the cost of reading the clock, shown as "clock".
+  // smartDirection() builds the flow field on its first call in a tick and
+  // only looks it up on the rest, so a median over many calls would hide
+  // the build; the build is timed as a query of its own, rebuildFlowField,
+  // over one call in 50 (it touches every person), and smartDirection is
+  // timed on the field it leaves.  distZombie() has nothing to build, since
+  // the zombie field is kept up to date as zombies move.
+  // destroyOfType() runs last on each world, since it kills what it finds.
+
+static const char* const queryNames[] = {
+    "clock", "boundaryBoxIntersect", "isValidDestination", "overlapOfType",
+    "distZombie", "rebuildFlowField", "smartDirection", "destroyOfType"
+};
+static const int NUM_QUERIES = sizeof(queryNames) / sizeof(queryNames[0]);
+
+  // Actors can make sounds and set the status line while being destroyed,
+  // so the worlds need something to send them to
+
+class SilentController : public WorldController
+{
+  public:
+    virtual bool getLastKey(int& /* value */)
+    {
+        return false;
+    }
+
+    virtual void playSound(int /* soundID */)
+    {
+    }
+
+    virtual void setGameStatText(string /* text */)
+    {
+    }
+
+    virtual void quitGame()
+    {
+    }
+};
+
+  // Fills a world of about four cells per actor, bordered by walls, with
+  // population actors in random cells: walls, citizens, dumb and smart
+  // zombies, and vaccine goodies.  Penelope starts in the middle.
+
+static void buildWorld(StudentWorld& world, int population, RandomGenerator& rng,
+                       vector<Actor*>& people, vector<Actor*>& smartZombies)
+{
+    int side = max(16, static_cast<int>(ceil(sqrt(4.0 * population))) + 2);
+    world.beginLevel(side * SPRITE_WIDTH, side * SPRITE_HEIGHT);
+    for (int k = 0; k < side; k++)
+    {
+        world.spawn<Wall>(k * SPRITE_WIDTH, 0);
+        world.spawn<Wall>(k * SPRITE_WIDTH, (side-1) * SPRITE_HEIGHT);
+        if (k > 0  &&  k < side - 1)
+        {
+            world.spawn<Wall>(0, k * SPRITE_HEIGHT);
+            world.spawn<Wall>((side-1) * SPRITE_WIDTH, k * SPRITE_HEIGHT);
+        }
+    }
+
+      // Shuffle just enough of the interior cells to pick one for each actor
+    vector<int> cells;
+    for (int y = 1; y < side - 1; y++)
+        for (int x = 1; x < side - 1; x++)
+            if (x != side/2  ||  y != side/2)
+                cells.push_back(y * side + x);
+    for (int k = 0; k < population; k++)
+        swap(cells[k], cells[rng.randInt(k, static_cast<int>(cells.size()) - 1)]);
+
+    world.addPenelope(side/2 * SPRITE_WIDTH, side/2 * SPRITE_HEIGHT);
+    for (int k = 0; k < population; k++)
+    {
+        int x = cells[k] % side * SPRITE_WIDTH;
+        int y = cells[k] / side * SPRITE_HEIGHT;
+        int kind = rng.randInt(0, 19);
+        if (kind < 3)
+            world.spawn<Wall>(x, y);
+        else if (kind < 11)
+            people.push_back(world.spawn<Citizen>(x, y));
+        else if (kind < 17)
+            people.push_back(world.spawn<Zombie>(x, y));
+        else if (kind < 19)
+        {
+            Actor* zombie = world.spawn<SmartZombie>(x, y);
+            people.push_back(zombie);
+            smartZombies.push_back(zombie);
+        }
+        else
+            world.spawn<VaccineGoodie>(x, y);
+    }
+    world.finishLoading();
+}
+
+  // Times calls calls of one query, given the index of each call, and
+  // records the latency of each in h
+
+template<typename Func>
+static void timeQuery(int calls, Profiler::Histogram& h, Func query)
+{
+    for (int i = 0; i < calls; i++)
+    {
+        auto start = chrono::steady_clock::now();
+        query(i);
+        auto end = chrono::steady_clock::now();
+        h.record(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+    }
+}
+
+static void usage()
+{
+    cout << "usage: ZombieDashMicrobenchmark [-n calls] [-s seed] [-p maxPopulation] [-b baselineFile] [-t tolerance] [-u]" << endl;
+}
+
+  // Reads the slope of each query from a baseline file, whose lines are
+  // "query slope"; blank lines and lines starting with # are ignored
+
+static bool loadBaseline(const string& filename, map<string, double>& slopes)
+{
+    ifstream baselineFile(filename);
+    if (!baselineFile)
+        return false;
+    string line;
+    while (getline(baselineFile, line))
+    {
+        if (line.empty()  ||  line[0] == '#')
+            continue;
+        istringstream iss(line);
+        string name;
+        double slope;
+        if (iss >> name >> slope)
+            slopes[name] = slope;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    int calls = 5000;
+    unsigned long long seed = 1;
+    int maxPopulation = 100000;
+    string baselineFile = "ZombieDash/microbenchmarkBaseline.txt";
+    double tolerance = 0.15;
+    bool updateBaseline = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "-u")
+        {
+            updateBaseline = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            usage();
+            return 1;
+        }
+        if (arg == "-n")
+            calls = atoi(argv[++i]);
+        else if (arg == "-s")
+            seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "-p")
+            maxPopulation = atoi(argv[++i]);
+        else if (arg == "-b")
+            baselineFile = argv[++i];
+        else if (arg == "-t")
+            tolerance = atof(argv[++i]);
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+    if (calls < 1  ||  maxPopulation < 10)
+    {
+        usage();
+        return 1;
+    }
+
+    map<string, double> baseline;
+    if (!updateBaseline  &&  !loadBaseline(baselineFile, baseline))
+    {
+        cerr << "Cannot read baseline " << baselineFile << " (run with -u to create it)" << endl;
+        return 1;
+    }
+
+    vector<int> populations;
+    for (int population = 10; population <= maxPopulation; population *= 10)
+        populations.push_back(population);
+    vector<vector<double>> medians(NUM_QUERIES);
+
+    SilentController controller;
+    long sink = 0;
+    cout << left << setw(22) << "query" << right << setw(10) << "actors" << setw(8) << "side"
+         << setw(10) << "p50 ns" << setw(10) << "p99 ns" << setw(10) << "max ns" << endl;
+    for (int population : populations)
+    {
+        RandomGenerator rng(seed, population);
+        StudentWorld world("");
+        world.setSeed(seed);
+        world.setController(&controller);
+        vector<Actor*> people;
+        vector<Actor*> smartZombies;
+        buildWorld(world, population, rng, people, smartZombies);
+
+          // Pick every call's arguments ahead of time, so only the queries
+          // themselves are timed
+        vector<int> x(calls), y(calls), dx(calls), dy(calls);
+        vector<Actor*> mover(calls), smart(calls);
+        for (int i = 0; i < calls; i++)
+        {
+            x[i] = rng.randInt(0, world.width() - 1);
+            y[i] = rng.randInt(0, world.height() - 1);
+            dx[i] = rng.randInt(-SPRITE_WIDTH * 2, SPRITE_WIDTH * 2);
+            dy[i] = rng.randInt(-SPRITE_HEIGHT * 2, SPRITE_HEIGHT * 2);
+            mover[i] = people.empty() ? nullptr : people[rng.randInt(0, static_cast<int>(people.size()) - 1)];
+            smart[i] = smartZombies.empty() ? nullptr : smartZombies[rng.randInt(0, static_cast<int>(smartZombies.size()) - 1)];
+        }
+
+        vector<Profiler::Histogram> h(NUM_QUERIES);
+        timeQuery(calls, h[0], [&](int) { });
+        timeQuery(calls, h[1], [&](int i) {
+            sink += world.boundaryBoxIntersect(x[i], y[i], x[i] + dx[i], y[i] + dy[i]);
+        });
+        if (!people.empty())
+            timeQuery(calls, h[2], [&](int i) {
+                const int step[] = { 4, -4 };
+                sink += world.isValidDestination(mover[i]->getX() + step[i % 2] * (i % 4 < 2),
+                                                 mover[i]->getY() + step[i % 2] * (i % 4 >= 2), mover[i]);
+            });
+        timeQuery(calls, h[3], [&](int i) {
+            sink += world.overlapOfType(x[i], y[i], Actor::INFECTABLE);
+        });
+        timeQuery(calls, h[4], [&](int i) {
+            sink += static_cast<long>(world.distZombie(x[i], y[i]));
+        });
+        timeQuery(max(calls / 50, 1), h[5], [&](int) {
+            world.rebuildFlowField();
+        });
+        if (!smartZombies.empty())
+        {
+            RandomGenerator aiRandom(seed, 0);
+            timeQuery(calls, h[6], [&](int i) {
+                int distance = 10;
+                sink += world.smartDirection(smart[i]->getX(), smart[i]->getY(), distance, aiRandom) + distance;
+            });
+        }
+        timeQuery(calls, h[7], [&](int i) {
+            world.destroyOfType(x[i], y[i], Actor::FLAMMABLE);
+        });
+
+        for (int q = 0; q < NUM_QUERIES; q++)
+        {
+            if (h[q].count() == 0)
+            {
+                medians[q].push_back(0);
+                continue;
+            }
+            medians[q].push_back(static_cast<double>(h[q].percentile(0.5)));
+            cout << left << setw(22) << queryNames[q] << right << setw(10) << population
+                 << setw(8) << world.width() / SPRITE_WIDTH << setw(10) << h[q].percentile(0.5)
+                 << setw(10) << h[q].percentile(0.99) << setw(10) << h[q].max() << endl;
+        }
+        world.cleanUp();
+    }
+
+      // Fit log(median) = a + slope * log(population) over the worlds each
+      // query ran on
+    bool failed = false;
+    ostringstream measured;
+    measured << "# Scaling slopes of ZombieDashMicrobenchmark's queries, written by -u" << endl;
+    cout << endl << "scaling slopes (tolerance " << tolerance << ")" << endl;
+    cout << left << setw(22) << "query" << right << setw(10) << "slope" << setw(10) << "baseline" << endl;
+    ios_base::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    for (int q = 0; q < NUM_QUERIES; q++)
+    {
+        double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (size_t k = 0; k < populations.size(); k++)
+        {
+            if (medians[q][k] <= 0)
+                continue;
+            double lx = log(static_cast<double>(populations[k]));
+            double ly = log(medians[q][k]);
+            n++;
+            sx += lx;
+            sy += ly;
+            sxx += lx * lx;
+            sxy += lx * ly;
+        }
+        if (n < 2)
+            continue;
+        double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+        measured << queryNames[q] << ' ' << fixed << setprecision(3) << slope << endl;
+        cout << left << setw(22) << queryNames[q] << right << fixed << setprecision(3) << setw(10) << slope;
+        if (updateBaseline)
+        {
+            cout << endl;
+            continue;
+        }
+        auto expected = baseline.find(queryNames[q]);
+        if (expected == baseline.end())
+        {
+            cout << setw(10) << "-" << "  new" << endl;
+            continue;
+        }
+        bool ok = slope <= expected->second + tolerance;
+        cout << setw(10) << expected->second << (ok ? "  ok" : "  FAIL") << endl;
+        if (!ok)
+        {
+            cerr << "FAIL: " << queryNames[q] << " scales with slope " << slope
+                 << ", more than " << tolerance << " above its baseline of " << expected->second << endl;
+            failed = true;
+        }
+    }
+    cout.flags(flags);
+    cout.precision(precision);
+
+    if (updateBaseline)
+    {
+        ofstream out(baselineFile);
+        out << measured.str();
+        if (!out)
+        {
+            cerr << "Cannot write baseline " << baselineFile << endl;
+            return 1;
+        }
+    }
+    if (sink == 42)    // keeps the queries' results from being optimized away
+        cout << endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+#include "Check.h"
+#include "Arena.h"
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+using namespace std;
+
+TEST(ArenaReusesReleasedMemory)
+{
+    Arena arena;
+    void* a = arena.allocate(40);
+    void* b = arena.allocate(100);
+    void* c = arena.allocate(40);
+    CHECK(a != c);
+    size_t used = arena.bytesUsed();
+    CHECK(used >= 180);
+
+      // Memory released goes to the next allocation of its size, and to
+      // no other
+    arena.release(a);
+    CHECK(arena.bytesUsed() < used);
+    void* d = arena.allocate(100);
+    CHECK(d != a);
+    CHECK_EQ(arena.allocate(40), a);
+
+    arena.release(a);
+    arena.release(b);
+    arena.release(c);
+    arena.release(d);
+    CHECK_EQ(arena.bytesUsed(), static_cast<size_t>(0));
+}
+
+TEST(ArenaStaysBoundedUnderChurn)
+{
+      // Objects of a few sizes come and go at random with never more than
+      // 200 alive, as actors do during a level; the arena must not keep
+      // growing, and every allocation must be aligned and not overlap one
+      // still alive
+    Arena arena;
+    mt19937 rng(271828);
+    const size_t sizes[] = { 24, 72, 136 };
+    struct Live
+    {
+        unsigned char* p;
+        size_t         size;
+    };
+    vector<Live> live;
+    size_t capacity = 0;
+    int overlaps = 0;
+    int misaligned = 0;
+    for (int step = 0; step < 20000; step++)
+    {
+        if (live.size() < 200  &&  (live.empty()  ||  rng() % 2 == 0))
+        {
+            size_t size = sizes[rng() % 3];
+            Live object = { static_cast<unsigned char*>(arena.allocate(size)), size };
+            if (reinterpret_cast<uintptr_t>(object.p) % alignof(max_align_t) != 0)
+                misaligned++;
+            for (const Live& other : live)
+                if (object.p < other.p + other.size  &&  other.p < object.p + object.size)
+                    overlaps++;
+            live.push_back(object);
+        }
+        else
+        {
+            size_t k = rng() % live.size();
+            arena.release(live[k].p);
+            live[k] = live.back();
+            live.pop_back();
+        }
+        if (step == 5000)
+            capacity = arena.capacity();
+    }
+    CHECK_EQ(overlaps, 0);
+    CHECK_EQ(misaligned, 0);
+    CHECK_EQ(arena.capacity(), capacity);
+
+    for (const Live& object : live)
+        arena.release(object.p);
+    arena.reset();
+    CHECK_EQ(arena.bytesUsed(), static_cast<size_t>(0));
+    CHECK_EQ(arena.capacity(), capacity);
+}
@@ -0,0 +1,64 @@
+#ifndef CHECK_H_
+#define CHECK_H_
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+  // Just enough of a test framework for ZombieDashTests.  TEST(name) defines
+  // a test and registers it with the runner in tests.cpp; CHECK(condition)
+  // and CHECK_EQ(actual, expected) report a failed check and let the test
+  // go on, so one run shows every check that fails.
+
+typedef void (*TestFunction)();
+
+struct TestCase
+{
+    const char*  name;
+    TestFunction function;
+};
+
+std::vector<TestCase>& testCases();
+
+  // Counts a failed check and reports where it was
+void checkFailed(const char* file, int line, const std::string& message);
+
+  // The directory the determinism data lives in, and whether to rewrite its
+  // expected results instead of checking them, as given on the command line
+const std::string& testDataDirectory();
+bool updatingExpectedResults();
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* name, TestFunction function)
+    {
+        testCases().push_back(TestCase{ name, function });
+    }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) \
+            checkFailed(__FILE__, __LINE__, "CHECK(" #condition ")"); \
+    } while (false)
+
+template<typename A, typename E>
+void checkEqual(const A& actual, const E& expected, const char* expression, const char* file, int line)
+{
+    if (actual == expected)
+        return;
+    std::ostringstream message;
+    message << "CHECK_EQ(" << expression << "): got " << actual << ", expected " << expected;
+    checkFailed(file, line, message.str());
+}
+
+#define CHECK_EQ(actual, expected) \
+    checkEqual((actual), (expected), #actual ", " #expected, __FILE__, __LINE__)
+
+#endif // CHECK_H_
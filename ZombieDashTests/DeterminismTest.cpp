@@ -0,0 +1,132 @@
+#include "Check.h"
+#include "TestWorlds.h"
+#include "HeadlessController.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdint>
+using namespace std;
+
+  // Plays the headless games listed in expected.txt and checks each ends up
+  // where the file says, so that a change meant to leave the game alone can
+  // show it does.  Each line of the file is
+  //     levels keys seed threads ticks => ticksRun | status text
+  // where levels names a directory under levels/, keys names a key script
+  // under keys/ (or is "-" for no input), and the game runs for ticks ticks
+  // or until it ends, on that many threads.  Consecutive lines that differ
+  // only in ticks continue the same game.  Run with -u to rewrite the
+  // results after a change that is meant to change how games play out.
+  // The results were recorded from this engine, not from the original
+  // game, which could not be seeded and so never plays the same game
+  // twice; they show that a change leaves play as it was before it, not
+  // that play matches the original.
+
+namespace
+{
+    struct GameRun
+    {
+        string        levels;
+        string        keys;
+        std::uint64_t seed;
+        int           threads;
+        long          ticks;
+        string        expected;
+        int           line;     // index into the file's lines
+    };
+
+    bool sameGame(const GameRun& a, const GameRun& b)
+    {
+        return a.levels == b.levels  &&  a.keys == b.keys  &&  a.seed == b.seed  &&
+               a.threads == b.threads  &&  a.ticks <= b.ticks;
+    }
+}
+
+TEST(DeterministicGames)
+{
+    string path = testDataDirectory() + "/expected.txt";
+    ifstream expectedFile(path);
+    if (!expectedFile)
+    {
+        checkFailed(__FILE__, __LINE__, "cannot read " + path);
+        return;
+    }
+
+    vector<string> lines;
+    vector<GameRun> runs;
+    string line;
+    while (getline(expectedFile, line))
+    {
+        lines.push_back(line);
+        if (line.empty()  ||  line[0] == '#')
+            continue;
+        GameRun run;
+        string arrow;
+        istringstream iss(line);
+        if (!(iss >> run.levels >> run.keys >> run.seed >> run.threads >> run.ticks >> arrow)  ||  arrow != "=>")
+        {
+            checkFailed(path.c_str(), static_cast<int>(lines.size()), "cannot parse \"" + line + "\"");
+            continue;
+        }
+        getline(iss >> ws, run.expected);
+        run.line = static_cast<int>(lines.size()) - 1;
+        runs.push_back(run);
+    }
+    expectedFile.close();
+    CHECK(!runs.empty());
+
+    QuietErrors quiet;
+    map<string, KeyScript> scripts;
+    unique_ptr<GameWorld> world;
+    unique_ptr<HeadlessController> controller;
+    for (int k = 0; k < runs.size(); k++)
+    {
+        const GameRun& run = runs[k];
+        if (k == 0  ||  !sameGame(runs[k-1], run))
+        {
+            KeySource* keys = nullptr;
+            if (run.keys != "-")
+            {
+                auto it = scripts.find(run.keys);
+                if (it == scripts.end())
+                {
+                    it = scripts.insert(make_pair(run.keys, KeyScript())).first;
+                    if (!it->second.load(testDataDirectory() + "/keys/" + run.keys))
+                        checkFailed(path.c_str(), run.line + 1, "cannot load key script " + run.keys);
+                }
+                keys = &it->second;
+            }
+            controller.reset();
+            world.reset(createTestWorld(run.levels));
+            world->setSeed(run.seed);
+            world->setThreads(run.threads);
+            controller.reset(new HeadlessController(world.get(), keys));
+        }
+        controller->run(run.ticks);
+
+        ostringstream actual;
+        actual << controller->ticks() << " | " << controller->gameStatText();
+        if (updatingExpectedResults())
+        {
+            ostringstream updated;
+            updated << run.levels << ' ' << run.keys << ' ' << run.seed << ' ' << run.threads << ' '
+                    << run.ticks << " => " << actual.str();
+            lines[run.line] = updated.str();
+        }
+        else if (actual.str() != run.expected)
+            checkFailed(path.c_str(), run.line + 1, "got \"" + actual.str() + "\", expected \"" + run.expected + "\"");
+    }
+    controller.reset();
+    world.reset();
+
+    if (updatingExpectedResults())
+    {
+        ofstream updatedFile(path);
+        for (const string& l : lines)
+            updatedFile << l << '\n';
+        if (!updatedFile)
+            checkFailed(__FILE__, __LINE__, "cannot write " + path);
+    }
+}
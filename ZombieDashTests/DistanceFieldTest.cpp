@@ -0,0 +1,181 @@
+#include "Check.h"
+#include "DistanceField.h"
+#include "Actor.h"
+#include "StudentWorld.h"
+#include <vector>
+#include <random>
+#include <memory>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+using namespace std;
+
+namespace
+{
+    class SiteProbe : public Actor
+    {
+      public:
+        SiteProbe(StudentWorld* world, int x, int y)
+         : Actor(IID_ZOMBIE, x, y, 0, 0, world)
+        {
+        }
+
+        virtual void doSomething()
+        {
+        }
+
+          // Moves without telling the world, which is not tracking probes
+        void place(int x, int y)
+        {
+            GraphObject::moveTo(x, y);
+        }
+    };
+
+      // The distance to the nearest live probe within maxDistance, or -1
+    double bruteForce(const vector<unique_ptr<SiteProbe>>& probes, const vector<bool>& live,
+                      double x, double y, double maxDistance)
+    {
+        double best = -1;
+        for (int k = 0; k < probes.size(); k++)
+        {
+            if (!live[k])
+                continue;
+            double dx = x - probes[k]->getX();
+            double dy = y - probes[k]->getY();
+            double d = sqrt(dx*dx + dy*dy);
+            if (d <= maxDistance  &&  (best < 0  ||  d < best))
+                best = d;
+        }
+        return best;
+    }
+}
+
+TEST(DistanceFieldMatchesBruteForce)
+{
+      // Sites come, go and move at random (sometimes out of the field, where
+      // they are clamped to an edge cell), and every lookup must give
+      // exactly the distance a search of all of them gives.  Starting with
+      // many sites and then removing them all covers lookups on both sides
+      // of the number of sites at which the field stops searching by ring.
+    StudentWorld world("");
+    mt19937 rng(8675309);
+    const int width = 400;
+    const int height = 240;
+    for (int resolution : { 8, 32, 100 })
+    {
+        DistanceField field(width, height, resolution);
+        vector<unique_ptr<SiteProbe>> probes;
+        vector<bool> live;
+        uniform_int_distribution<int> xs(-20, width + 20);
+        uniform_int_distribution<int> ys(-20, height + 20);
+        int mismatches = 0;
+        int lookups = 0;
+        auto lookUp = [&](int count) {
+            for (int q = 0; q < count; q++)
+            {
+                double x = xs(rng);
+                double y = ys(rng);
+                double maxDistance = q % 2 == 0 ? 83 : 1000;
+                double expected = bruteForce(probes, live, x, y, maxDistance);
+                double dist = -1;
+                bool found = field.nearest(x, y, maxDistance, dist);
+                if (found != (expected >= 0)  ||  (found  &&  dist != expected))
+                    mismatches++;
+                lookups++;
+            }
+        };
+        for (int step = 0; step < 600; step++)
+        {
+            int action = uniform_int_distribution<int>(0, 9)(rng);
+            int k = probes.empty() ? -1 : uniform_int_distribution<int>(0, probes.size() - 1)(rng);
+            if (action < 4  ||  k < 0)
+            {
+                probes.emplace_back(new SiteProbe(&world, xs(rng), ys(rng)));
+                live.push_back(true);
+                field.insert(probes.back().get());
+            }
+            else if (action < 5  &&  live[k])
+            {
+                field.remove(probes[k].get());
+                live[k] = false;
+            }
+            else if (live[k])
+            {
+                  // Mostly small steps within a cell, sometimes a jump
+                double oldX = probes[k]->getX();
+                double oldY = probes[k]->getY();
+                if (action < 8)
+                    probes[k]->place(oldX + uniform_int_distribution<int>(-2, 2)(rng), oldY + uniform_int_distribution<int>(-2, 2)(rng));
+                else
+                    probes[k]->place(xs(rng), ys(rng));
+                field.move(probes[k].get(), oldX, oldY);
+            }
+            lookUp(20);
+        }
+        int count = 0;
+        for (bool l : live)
+            count += l;
+        CHECK_EQ(field.sites(), count);
+        CHECK(count > 120);
+
+        for (int k = 0; k < probes.size(); k++)
+            if (live[k])
+            {
+                field.remove(probes[k].get());
+                live[k] = false;
+                lookUp(5);
+            }
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(field.sites(), 0);
+        field.insert(probes[0].get());
+        field.clear();
+        CHECK_EQ(field.sites(), 0);
+        double dist;
+        CHECK(!field.nearest(width / 2, height / 2, 1000, dist));
+    }
+}
+
+TEST(DistanceFieldIncludesExactRange)
+{
+    StudentWorld world("");
+    DistanceField field(VIEW_WIDTH, VIEW_HEIGHT, 2*SPRITE_WIDTH);
+    SiteProbe site(&world, 100, 100);
+    field.insert(&site);
+    double dist = 0;
+      // 82 pixels away counts as within 82; 82.006 does not
+    CHECK(field.nearest(182, 100, 82, dist));
+    CHECK_EQ(dist, 82.0);
+    CHECK(!field.nearest(182, 101, 82, dist));
+    CHECK(field.nearest(100, 100, 0, dist));
+    CHECK_EQ(dist, 0.0);
+}
+
+TEST(DistZombieIsExactWhereCitizensLook)
+{
+      // A citizen at (100, 100) has the nearest zombie 80.6 pixels away, so
+      // it flees, and stepping up or right puts it 82.04 pixels from one
+      // zombie or the other.  Both steps must see 82 (in whole pixels), as
+      // a search of every zombie does, for the citizen to break the tie the
+      // same way; more generally, every distance up to 83 must be exact.
+    StudentWorld world("");
+    world.beginLevel(VIEW_WIDTH, VIEW_HEIGHT);
+    world.addPenelope(240, 240);
+    world.spawn<Zombie>(84, 20);
+    world.spawn<Zombie>(43, 43);
+    world.finishLoading();
+    CHECK_EQ(world.distZombie(100, 100), 80.0);
+    CHECK_EQ(world.distZombie(100, 102), 82.0);
+    CHECK_EQ(world.distZombie(102, 100), 82.0);
+
+    int mismatches = 0;
+    for (int y = 0; y < VIEW_HEIGHT; y++)
+        for (int x = 0; x < VIEW_WIDTH; x++)
+        {
+            double nearest = min(hypot(x - 84.0, y - 20.0), hypot(x - 43.0, y - 43.0));
+            double expected = nearest <= 83 ? static_cast<int>(nearest) : INT_MAX;
+            if (world.distZombie(x, y) != expected)
+                mismatches++;
+        }
+    CHECK_EQ(mismatches, 0);
+    world.cleanUp();
+}
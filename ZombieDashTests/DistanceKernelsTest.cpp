@@ -0,0 +1,53 @@
+#include "Check.h"
+#include "DistanceKernels.h"
+#include <vector>
+#include <random>
+#include <cmath>
+using namespace std;
+
+TEST(DistanceKernelsMatchScalar)
+{
+      // Whole-pixel positions crowded into a small area, so there are many
+      // ties, in every length around the vector widths.  The vector kernel
+      // must pick the same position at the same squared distance as the
+      // plain loop.
+    mt19937 rng(1234);
+    uniform_int_distribution<int> coordinate(0, 24);
+    int mismatches = 0;
+    for (int count = 0; count <= 70; count++)
+    {
+        for (int trial = 0; trial < 200; trial++)
+        {
+            vector<double> xs(count), ys(count);
+            for (int i = 0; i < count; i++)
+            {
+                xs[i] = coordinate(rng);
+                ys[i] = coordinate(rng);
+            }
+            double x = coordinate(rng);
+            double y = coordinate(rng);
+            double vectorDist = -1;
+            double scalarDist = -1;
+            int vectorIndex = nearestPosition(xs.data(), ys.data(), count, x, y, vectorDist);
+            int scalarIndex = nearestPositionScalar(xs.data(), ys.data(), count, x, y, scalarDist);
+            if (vectorIndex != scalarIndex  ||  (count > 0  &&  vectorDist != scalarDist))
+                mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    double dist;
+    CHECK_EQ(nearestPosition(nullptr, nullptr, 0, 0, 0, dist), -1);
+}
+
+TEST(SquaredDistancesDecideLikeDistances)
+{
+      // Comparing whole-pixel squared distances with radius*radius must
+      // decide exactly as comparing their square roots with the radius did
+    int mismatches = 0;
+    for (int radius = 0; radius <= 100; radius++)
+        for (int squared = 0; squared <= 3 * 100 * 100; squared++)
+            if ((sqrt(static_cast<double>(squared)) <= radius) != (squared <= radius * radius))
+                mismatches++;
+    CHECK_EQ(mismatches, 0);
+}
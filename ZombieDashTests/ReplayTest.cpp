@@ -0,0 +1,112 @@
+#include "Check.h"
+#include "TestWorlds.h"
+#include "Replay.h"
+#include "HeadlessController.h"
+#include "GameConstants.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+using namespace std;
+
+TEST(ReplayRoundTripsKeys)
+{
+      // One of each kind of code, and idle runs whose varints take one,
+      // two and three bytes
+    const int keys[] = {
+        'a', 0, KEY_PRESS_LEFT, KEY_PRESS_RIGHT, KEY_PRESS_UP, KEY_PRESS_DOWN,
+        KEY_PRESS_SPACE, KEY_PRESS_TAB, KEY_PRESS_ENTER, 0x7F, 0x80, 0xFF, 0, 0
+    };
+    const int idleRuns[] = { 1, 127, 128, 20000 };
+    vector<int> ticks;
+    for (int run : idleRuns)
+    {
+        for (int key : keys)
+            ticks.push_back(key);
+        ticks.insert(ticks.end(), run, 0);
+    }
+    const long levelTwo = static_cast<long>(ticks.size()) / 2;
+    const uint64_t seed = 0xFEDCBA9876543210ULL;
+
+    string path = temporaryFile("ZombieDashTests-keys.zdr");
+    {
+        ReplayRecorder recorder;
+        CHECK(recorder.open(path, seed));
+        recorder.levelStarted(1);
+        for (long tick = 0; tick < ticks.size(); tick++)
+        {
+            if (tick == levelTwo)
+                recorder.levelStarted(2);
+            if (ticks[tick] != 0)
+                recorder.keyReturned(ticks[tick]);
+            recorder.tickEnded();
+        }
+    }
+
+    ReplayPlayer player;
+    CHECK(player.load(path));
+    CHECK_EQ(player.seed(), seed);
+    CHECK_EQ(player.ticks(), static_cast<long>(ticks.size()));
+    int mismatches = 0;
+    for (long tick = 0; tick < ticks.size(); tick++)
+    {
+        int value = 0;
+        bool hit = player.getKey(tick, value);
+        if (hit != (ticks[tick] != 0)  ||  (hit  &&  value != ticks[tick]))
+            mismatches++;
+    }
+    CHECK_EQ(mismatches, 0);
+    player.levelStarted(0, 1);
+    player.levelStarted(levelTwo, 2);
+    CHECK(!player.desynced());
+
+      // A level starting a tick late is a desync
+    ReplayPlayer late;
+    CHECK(late.load(path));
+    late.levelStarted(0, 1);
+    late.levelStarted(levelTwo + 1, 2);
+    CHECK(late.desynced());
+
+    remove(path.c_str());
+}
+
+TEST(ReplayReproducesGame)
+{
+      // Record a scripted game across a level change, then play the
+      // recording back in a fresh world and end up in the same place
+    const long ticks = 3000;
+    string path = temporaryFile("ZombieDashTests-game.zdr");
+    QuietErrors quiet;
+
+    KeyScript script;
+    if (!script.load(testDataDirectory() + "/keys/wander.txt"))
+    {
+        checkFailed(__FILE__, __LINE__, "cannot load key script wander.txt");
+        return;
+    }
+    unique_ptr<GameWorld> recorded(createTestWorld("campaign"));
+    recorded->setSeed(11);
+    HeadlessController recording(recorded.get(), &script);
+    ReplayRecorder recorder;
+    CHECK(recorder.open(path, recorded->getSeed()));
+    recording.setRecorder(&recorder);
+    recording.run(ticks);
+    recorder.close();
+    CHECK(recorded->getLevel() > 1);
+
+    ReplayPlayer player;
+    CHECK(player.load(path));
+    CHECK_EQ(player.ticks(), recording.ticks());
+    unique_ptr<GameWorld> replayed(createTestWorld("campaign"));
+    replayed->setSeed(player.seed());
+    HeadlessController playing(replayed.get(), &player);
+    playing.run(player.ticks());
+
+    CHECK(!player.desynced());
+    CHECK_EQ(playing.ticks(), recording.ticks());
+    CHECK_EQ(playing.gameStatText(), recording.gameStatText());
+    CHECK_EQ(replayed->getLevel(), recorded->getLevel());
+    CHECK_EQ(replayed->getLives(), recorded->getLives());
+    CHECK_EQ(replayed->getScore(), recorded->getScore());
+
+    remove(path.c_str());
+}
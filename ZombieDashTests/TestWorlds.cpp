@@ -0,0 +1,20 @@
+#include "TestWorlds.h"
+#include "Check.h"
+#include <cstdlib>
+using namespace std;
+
+GameWorld* createStudentWorld(string assetPath = "");
+
+GameWorld* createTestWorld(const string& levels)
+{
+    return createStudentWorld(testDataDirectory() + "/levels/" + levels + "/");
+}
+
+string temporaryFile(const string& name)
+{
+    const char* directory = getenv("TMPDIR");
+    string path = directory != nullptr  &&  *directory != '\0' ? directory : "/tmp";
+    if (path.back() != '/')
+        path += '/';
+    return path + name;
+}
@@ -0,0 +1,40 @@
+#ifndef TESTWORLDS_H_
+#define TESTWORLDS_H_
+
+#include "GameWorld.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+  // Creates a world that plays the levels in the directory of that name
+  // under testDataDirectory()/levels
+GameWorld* createTestWorld(const std::string& levels);
+
+  // The path of a scratch file of that name in the temporary directory
+std::string temporaryFile(const std::string& name);
+
+  // Swallows what the world writes to cerr (e.g. "Successfully loaded
+  // level 1!") for as long as it exists
+
+class QuietErrors
+{
+  public:
+    QuietErrors()
+     : m_saved(std::cerr.rdbuf(m_sink.rdbuf()))
+    {
+    }
+
+    ~QuietErrors()
+    {
+        std::cerr.rdbuf(m_saved);
+    }
+
+    QuietErrors(const QuietErrors&) = delete;
+    QuietErrors& operator=(const QuietErrors&) = delete;
+
+  private:
+    std::ostringstream m_sink;
+    std::streambuf*    m_saved;
+};
+
+#endif // TESTWORLDS_H_
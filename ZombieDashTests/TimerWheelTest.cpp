@@ -0,0 +1,213 @@
+#include "Check.h"
+#include "TimerWheel.h"
+#include "Actor.h"
+#include "StudentWorld.h"
+#include <vector>
+#include <random>
+#include <memory>
+using namespace std;
+
+namespace
+{
+      // An actor that notes the ticks its timer goes off at.  From inside
+      // timerExpired() it can schedule its timer again, or cancel another.
+
+    class TimerProbe : public Actor
+    {
+      public:
+        TimerProbe(StudentWorld* world, TimerWheel& wheel)
+         : Actor(IID_WALL, 0, 0, 0, 0, world), m_wheel(wheel)
+        {
+        }
+
+        virtual void doSomething()
+        {
+        }
+
+        virtual void timerExpired()
+        {
+            fired.push_back(m_wheel.now());
+            if (repeatEvery >= 0)
+                m_wheel.schedule(timer, this, m_wheel.now() + repeatEvery);
+            if (cancelOnExpiry != nullptr)
+                cancelOnExpiry->cancel();
+        }
+
+        TimerWheel::Timer  timer;
+        vector<long>       fired;
+        long               repeatEvery = -1;       // reschedule this far on, if not negative
+        TimerWheel::Timer* cancelOnExpiry = nullptr;
+
+      private:
+        TimerWheel& m_wheel;
+    };
+
+      // The wheel covers 2^24 ticks in four levels of 64 slots
+    const long WHEEL_SPAN = 1L << 24;
+}
+
+TEST(TimerWheelFiresAcrossLevels)
+{
+    const long delays[] = {
+        1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097, 100000,
+        262143, 262144, 262145, WHEEL_SPAN - 1, WHEEL_SPAN, WHEEL_SPAN + 70000
+    };
+    const int count = sizeof(delays) / sizeof(delays[0]);
+
+      // Start on and off the slot boundaries, so timers are cascaded down
+      // from every level both whole and part way through a slot
+    for (long start : { 0L, 1L, 63L, 12345L, 262143L })
+    {
+        StudentWorld world("");
+        TimerWheel wheel;
+        wheel.advance(start);
+        vector<unique_ptr<TimerProbe>> probes;
+        for (int k = 0; k < count; k++)
+        {
+            probes.emplace_back(new TimerProbe(&world, wheel));
+            wheel.schedule(probes[k]->timer, probes[k].get(), start + delays[k]);
+            CHECK(probes[k]->timer.pending());
+        }
+        wheel.advance(start + delays[count-1] + 1000);
+        for (int k = 0; k < count; k++)
+        {
+            CHECK_EQ(probes[k]->fired.size(), 1u);
+            if (probes[k]->fired.size() == 1)
+                CHECK_EQ(probes[k]->fired[0], start + delays[k]);
+            CHECK(!probes[k]->timer.pending());
+        }
+    }
+}
+
+TEST(TimerWheelMatchesReference)
+{
+      // Schedule, reschedule and cancel timers at random while the wheel
+      // moves on in random steps, and check each goes off exactly when a
+      // plain list of expiry ticks says it should
+    StudentWorld world("");
+    TimerWheel wheel;
+    mt19937 rng(20190215);
+    const int count = 400;
+    vector<unique_ptr<TimerProbe>> probes;
+    vector<long> expires(count, -1);
+    vector<vector<long>> expected(count);
+    for (int k = 0; k < count; k++)
+        probes.emplace_back(new TimerProbe(&world, wheel));
+
+    for (int step = 0; step < 4000; step++)
+    {
+        for (int n = uniform_int_distribution<int>(0, 5)(rng); n > 0; n--)
+        {
+            int k = uniform_int_distribution<int>(0, count-1)(rng);
+            if (uniform_int_distribution<int>(0, 4)(rng) == 0)
+            {
+                probes[k]->timer.cancel();
+                expires[k] = -1;
+                continue;
+            }
+              // Delays spread over every level, including past the wheel
+            int bits = uniform_int_distribution<int>(0, 25)(rng);
+            long delay = uniform_int_distribution<long>(0, (1L << bits) - 1)(rng);
+            long tick = wheel.now() + delay;
+            wheel.schedule(probes[k]->timer, probes[k].get(), tick);
+            expires[k] = max(tick, wheel.now() + 1);
+        }
+        long to = wheel.now() + uniform_int_distribution<long>(1, step % 100 == 99 ? 1L << 22 : 300)(rng);
+        wheel.advance(to);
+        for (int k = 0; k < count; k++)
+            if (expires[k] >= 0  &&  expires[k] <= to)
+            {
+                expected[k].push_back(expires[k]);
+                expires[k] = -1;
+            }
+    }
+
+    for (int k = 0; k < count; k++)
+    {
+        CHECK(probes[k]->fired == expected[k]);
+        CHECK_EQ(probes[k]->timer.pending(), expires[k] >= 0);
+    }
+}
+
+TEST(TimerWheelCancels)
+{
+    StudentWorld world("");
+    TimerWheel wheel;
+
+      // A cancelled timer never goes off, at any level
+    TimerProbe near(&world, wheel);
+    TimerProbe far(&world, wheel);
+    wheel.schedule(near.timer, &near, 10);
+    wheel.schedule(far.timer, &far, 100000);
+    near.timer.cancel();
+    far.timer.cancel();
+    CHECK(!near.timer.pending());
+    CHECK(!far.timer.pending());
+    near.timer.cancel();    // cancelling twice is harmless
+
+      // A timer destroyed with its actor unlinks itself without disturbing
+      // the others in its slot
+    TimerProbe before(&world, wheel);
+    TimerProbe after(&world, wheel);
+    wheel.schedule(before.timer, &before, 20);
+    {
+        TimerProbe doomed(&world, wheel);
+        wheel.schedule(doomed.timer, &doomed, 20);
+    }
+    wheel.schedule(after.timer, &after, 20);
+
+      // Of two timers due the same tick that each cancel the other when
+      // they go off, only the first goes off
+    TimerProbe first(&world, wheel);
+    TimerProbe second(&world, wheel);
+    wheel.schedule(first.timer, &first, 30);
+    wheel.schedule(second.timer, &second, 30);
+    first.cancelOnExpiry = &second.timer;
+    second.cancelOnExpiry = &first.timer;
+
+    wheel.advance(200000);
+    CHECK(near.fired.empty());
+    CHECK(far.fired.empty());
+    CHECK(before.fired == vector<long>{ 20 });
+    CHECK(after.fired == vector<long>{ 20 });
+    CHECK_EQ(first.fired.size() + second.fired.size(), 1u);
+}
+
+TEST(TimerWheelReschedulesFromCallback)
+{
+    StudentWorld world("");
+    TimerWheel wheel;
+
+      // Timers that schedule themselves again, within level 0 and across
+      // the level 1 boundary
+    TimerProbe often(&world, wheel);
+    TimerProbe seldom(&world, wheel);
+    often.repeatEvery = 7;
+    seldom.repeatEvery = 100;
+    wheel.schedule(often.timer, &often, 3);
+    wheel.schedule(seldom.timer, &seldom, 50);
+
+      // A timer scheduled for the tick it goes off at goes off again on
+      // the next tick rather than in the same advance() loop
+    TimerProbe everyTick(&world, wheel);
+    everyTick.repeatEvery = 0;
+    wheel.schedule(everyTick.timer, &everyTick, 5);
+
+    wheel.advance(500);
+    vector<long> expected;
+    for (long t = 3; t <= 500; t += 7)
+        expected.push_back(t);
+    CHECK(often.fired == expected);
+    CHECK(seldom.fired == (vector<long>{ 50, 150, 250, 350, 450 }));
+    CHECK_EQ(everyTick.fired.size(), 496u);
+    CHECK_EQ(everyTick.fired.front(), 5);
+    CHECK_EQ(everyTick.fired.back(), 500);
+
+      // Rescheduling a pending timer moves it rather than adding another
+    TimerProbe moved(&world, wheel);
+    wheel.schedule(moved.timer, &moved, 600);
+    wheel.schedule(moved.timer, &moved, 520);
+    wheel.schedule(moved.timer, &moved, 9000);
+    wheel.advance(10000);
+    CHECK(moved.fired == vector<long>{ 9000 });
+}
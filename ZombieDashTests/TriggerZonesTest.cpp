@@ -0,0 +1,167 @@
+#include "Check.h"
+#include "TriggerZones.h"
+#include "Actor.h"
+#include "StudentWorld.h"
+#include <climits>
+using namespace std;
+
+namespace
+{
+    class TriggerProbe : public Actor
+    {
+      public:
+        TriggerProbe(StudentWorld* world, int x, int y)
+         : Actor(IID_LANDMINE, x, y, 0, 1, world)
+        {
+        }
+
+        virtual void doSomething()
+        {
+        }
+    };
+
+      // Takes the turns of every trigger queued before order before,
+      // leaving each awake or not, and returns how many there were
+    int takeTurns(TriggerZones& zones, long before, bool stayAwake)
+    {
+        int turns = 0;
+        while (zones.takeTurn(before) != nullptr)
+        {
+            zones.finishTurn(stayAwake);
+            turns++;
+        }
+        return turns;
+    }
+}
+
+TEST(TriggerZonesWakeWithinRadius)
+{
+    StudentWorld world("");
+    TriggerZones zones(VIEW_WIDTH, VIEW_HEIGHT, 10);
+    TriggerProbe mine(&world, 100, 100);
+    zones.insert(&mine, 1);
+    CHECK_EQ(zones.zones(), 1);
+    CHECK_EQ(zones.awake(), 1);
+
+      // New triggers take one turn before they sleep
+    zones.beginTick();
+    CHECK(zones.takeTurn(LONG_MAX) == &mine);
+    zones.finishTurn(false);
+    CHECK(zones.takeTurn(LONG_MAX) == nullptr);
+    zones.endTick();
+    CHECK_EQ(zones.awake(), 0);
+
+      // Just outside the zone (11 pixels, or 8 and 8 diagonally) does not
+      // wake it; on its edge does, in any neighboring cell
+    zones.enter(111, 100);
+    zones.enter(92, 92);
+    CHECK_EQ(zones.awake(), 0);
+    zones.enter(106, 108);
+    CHECK_EQ(zones.awake(), 1);
+    zones.enter(100, 90);
+    CHECK_EQ(zones.awake(), 1);     // already awake, so not queued twice
+
+    zones.beginTick();
+    CHECK_EQ(takeTurns(zones, LONG_MAX, false), 1);
+    zones.endTick();
+
+      // A removed trigger is forgotten even if it was awake
+    zones.enter(100, 100);
+    zones.remove(&mine);
+    CHECK_EQ(zones.zones(), 0);
+    CHECK_EQ(zones.awake(), 0);
+    zones.beginTick();
+    CHECK(zones.takeTurn(LONG_MAX) == nullptr);
+    zones.endTick();
+}
+
+TEST(TriggerZonesWakeAfterCursor)
+{
+    StudentWorld world("");
+    TriggerZones zones(VIEW_WIDTH, VIEW_HEIGHT, 10);
+    TriggerProbe early(&world, 20, 20);
+    TriggerProbe middle(&world, 100, 100);
+    TriggerProbe late(&world, 200, 200);
+    zones.insert(&early, 1);
+    zones.insert(&late, 9);
+    zones.insert(&middle, 5);
+
+      // Awake triggers take their turns in the order they joined the world
+    zones.beginTick();
+    CHECK(zones.takeTurn(LONG_MAX) == &early);
+    zones.finishTurn(false);
+    CHECK(zones.takeTurn(LONG_MAX) == &middle);
+    zones.finishTurn(false);
+    CHECK(zones.takeTurn(LONG_MAX) == &late);
+    zones.finishTurn(false);
+    zones.endTick();
+
+      // The actor with order 3 takes its turn and lands in the late and
+      // middle triggers' zones; their turns have yet to come this tick
+    zones.beginTick();
+    CHECK(zones.takeTurn(3) == nullptr);
+    zones.enter(200, 205);
+    zones.enter(100, 95);
+    CHECK(zones.queued());
+    CHECK(zones.takeTurn(5) == nullptr);
+    CHECK(zones.takeTurn(6) == &middle);
+    zones.finishTurn(false);
+    CHECK(zones.takeTurn(6) == nullptr);
+    CHECK(zones.takeTurn(LONG_MAX) == &late);
+    zones.finishTurn(true);     // stays awake for the next tick
+    CHECK(zones.takeTurn(LONG_MAX) == nullptr);
+    zones.endTick();
+
+    zones.beginTick();
+    CHECK(zones.takeTurn(LONG_MAX) == &late);
+    zones.finishTurn(false);
+    zones.endTick();
+    CHECK_EQ(zones.awake(), 0);
+}
+
+TEST(TriggerZonesWakeBeforeCursor)
+{
+    StudentWorld world("");
+    TriggerZones zones(VIEW_WIDTH, VIEW_HEIGHT, 10);
+    TriggerProbe early(&world, 20, 20);
+    TriggerProbe late(&world, 200, 200);
+    zones.insert(&early, 1);
+    zones.insert(&late, 9);
+    zones.beginTick();
+    takeTurns(zones, LONG_MAX, false);
+    zones.endTick();
+
+      // The actor with order 4 lands in the early trigger's zone after the
+      // early trigger's turn has passed, so it waits for the next tick
+    zones.beginTick();
+    CHECK(zones.takeTurn(4) == nullptr);
+    zones.enter(20, 25);
+    CHECK(!zones.queued());
+    CHECK_EQ(zones.awake(), 1);
+    CHECK_EQ(takeTurns(zones, LONG_MAX, false), 0);
+    zones.endTick();
+
+    zones.beginTick();
+    CHECK(zones.takeTurn(LONG_MAX) == &early);
+    zones.finishTurn(false);
+    zones.endTick();
+
+      // Between ticks (e.g. when actors spawned during the tick join the
+      // world) every wake-up is for the next tick, late triggers included
+    zones.enter(200, 200);
+    CHECK(!zones.queued());
+    zones.beginTick();
+    CHECK(zones.takeTurn(LONG_MAX) == &late);
+    zones.finishTurn(false);
+    CHECK(zones.takeTurn(LONG_MAX) == nullptr);
+    zones.endTick();
+
+      // An actor waking its own trigger's zone as it takes its turn (order
+      // equal to the cursor) also waits for the next tick
+    zones.beginTick();
+    CHECK(zones.takeTurn(9) == nullptr);
+    zones.enter(200, 200);
+    CHECK(!zones.queued());
+    zones.endTick();
+    CHECK_EQ(zones.awake(), 1);
+}
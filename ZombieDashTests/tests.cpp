@@ -0,0 +1,105 @@
+#include "Check.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+  // Runs the unit tests and the determinism check, e.g.
+  //     ZombieDashTests -d ZombieDashTests/determinism
+  //     ZombieDashTests TimerWheelFiresAcrossLevels ReplayRoundTripsKeys
+  // -d  directory holding the determinism levels, key scripts and expected
+  //     results (default "ZombieDashTests/determinism")
+  // -u  rewrite the expected results from this build instead of checking
+  //     them, after a change that is meant to change how games play out
+  // Any other arguments name the tests to run (default: all of them).
+  // Exits with 0 if every check passed, or 1 if any failed.
+
+static string dataDirectory = "ZombieDashTests/determinism";
+static bool updateExpected = false;
+static int failures = 0;
+
+vector<TestCase>& testCases()
+{
+    static vector<TestCase> cases;
+    return cases;
+}
+
+void checkFailed(const char* file, int line, const string& message)
+{
+    cout << "  " << file << ":" << line << ": " << message << endl;
+    failures++;
+}
+
+const string& testDataDirectory()
+{
+    return dataDirectory;
+}
+
+bool updatingExpectedResults()
+{
+    return updateExpected;
+}
+
+static void usage()
+{
+    cout << "usage: ZombieDashTests [-d dataDirectory] [-u] [test ...]" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    vector<string> selected;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "-d"  &&  i + 1 < argc)
+            dataDirectory = argv[++i];
+        else if (arg == "-u")
+            updateExpected = true;
+        else if (!arg.empty()  &&  arg[0] == '-')
+        {
+            usage();
+            return 1;
+        }
+        else
+            selected.push_back(arg);
+    }
+
+      // Many tests build worlds from the levels there, which would have
+      // no Penelope if the directory were missing
+    {
+        ifstream ifs(dataDirectory + "/expected.txt");
+        if (!ifs)
+        {
+            cout << "Cannot find expected.txt in " << dataDirectory << endl;
+            usage();
+            return 1;
+        }
+    }
+
+    int ran = 0;
+    int failed = 0;
+    for (const TestCase& test : testCases())
+    {
+        if (!selected.empty()  &&  find(selected.begin(), selected.end(), test.name) == selected.end())
+            continue;
+        cout << test.name << endl;
+        int failuresBefore = failures;
+        test.function();
+        ran++;
+        if (failures > failuresBefore)
+            failed++;
+    }
+
+    if (ran == 0)
+    {
+        cout << "No tests matched" << endl;
+        return 1;
+    }
+    cout << ran - failed << " of " << ran << " tests passed";
+    if (failures > 0)
+        cout << " (" << failures << " failed checks)";
+    cout << endl;
+    return failed == 0 ? 0 : 1;
+}